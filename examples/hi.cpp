@@ -1,6 +1,13 @@
 #include "tests/types.hpp"
+#include "tests/mem.hpp"
+#include "tests/search.hpp"
 #include "tests/atomic.hpp"
 #include "tests/containers.hpp"
+#include "tests/hash.hpp"
+#include "tests/hash_map.hpp"
+#include "tests/queue.hpp"
 #include "tests/syscalls.hpp"
+#include "tests/slot_alloc.hpp"
+#include "tests/arena.hpp"
 #include "tests/filesystem.hpp"
-#include "tests/file.hpp"
\ No newline at end of file
+#include "tests/file.hpp"
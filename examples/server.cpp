@@ -18,6 +18,9 @@ int main() {
     char client_bufs[8][256] = {};
     int client_count = 0;
 
+    // scratch memory for handling one message, rewound after each one
+    io::Arena request_arena;
+
     auto on_accept = [&](io::Socket& client) {
         if (client_count >= 8) return; // max clients
         io::out << "Client connected!" << io::out.endl;
@@ -32,8 +35,13 @@ int main() {
 
         auto on_recv = [&](void*, int n, io::Error e) {
             if (e == io::Error::None) {
-                buf[n] = 0;
-                io::out << "Client: " << buf << io::out.endl;
+                io::ArenaScope scope{ request_arena };
+                char* msg = request_arena.allocate_array<char>(static_cast<io::usize>(n) + 1);
+                if (msg) {
+                    for (int i = 0; i < n; ++i) msg[i] = buf[i];
+                    msg[n] = 0;
+                    io::out << "Client: " << msg << io::out.endl;
+                }
                 c.async_recv(buf, sizeof(client_bufs[idx]) - 1, on_recv);
             }
         };
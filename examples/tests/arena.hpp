@@ -0,0 +1,112 @@
+#pragma once
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../../hi/native/arena.hpp"
+
+// ============================================================
+//                         Arena tests
+// ============================================================
+
+TEST_CASE("io::Arena bumps consecutive aligned allocations", "[io][arena]") {
+    io::Arena arena;
+    REQUIRE(arena.capacity() == 0); // nothing mapped until first use
+
+    auto* a = static_cast<io::u8*>(arena.allocate(3, 1));
+    auto* b = static_cast<io::u8*>(arena.allocate(5, 1));
+    REQUIRE(a != nullptr);
+    REQUIRE(b == a + 3);
+
+    void* c = arena.allocate(16, 64);
+    REQUIRE(reinterpret_cast<io::usize>(c) % 64 == 0);
+    REQUIRE(arena.capacity() >= IO_ARENA_BLOCK_BYTES);
+}
+
+TEST_CASE("io::Arena make and allocate_array construct typed storage", "[io][arena]") {
+    struct Pair { int a; double b; };
+
+    io::Arena arena;
+    Pair* p = arena.make<Pair>(Pair{ 7, 2.5 });
+    REQUIRE(p != nullptr);
+    REQUIRE(p->a == 7);
+    REQUIRE(p->b == 2.5);
+    REQUIRE(reinterpret_cast<io::usize>(p) % alignof(Pair) == 0);
+
+    io::u32* xs = arena.allocate_array<io::u32>(100);
+    REQUIRE(xs != nullptr);
+    for (io::u32 i = 0; i < 100; ++i) xs[i] = i * 3;
+    REQUIRE(xs[99] == 297);
+}
+
+TEST_CASE("io::Arena rewind reuses memory and keeps blocks mapped", "[io][arena]") {
+    io::Arena arena(4096);
+
+    void* keep = arena.allocate(32);
+    const io::Arena::Marker m = arena.mark();
+    void* first = arena.allocate(100);
+
+    // spill over several blocks
+    for (int i = 0; i < 64; ++i) REQUIRE(arena.allocate(1000) != nullptr);
+    const io::usize cap = arena.capacity();
+
+    arena.rewind(m);
+    REQUIRE(arena.allocate(100) == first);
+    for (int i = 0; i < 64; ++i) REQUIRE(arena.allocate(1000) != nullptr);
+    REQUIRE(arena.capacity() == cap); // second pass reused the same blocks
+
+    arena.reset();
+    REQUIRE(arena.allocate(32) == keep);
+
+    arena.release();
+    REQUIRE(arena.capacity() == 0);
+}
+
+TEST_CASE("io::Arena serves requests larger than a block", "[io][arena]") {
+    io::Arena arena(4096);
+    (void)arena.allocate(16);
+
+    const io::usize big = 1u << 20;
+    auto* p = static_cast<io::u8*>(arena.allocate(big));
+    REQUIRE(p != nullptr);
+    p[0] = 1; p[big - 1] = 2;
+    REQUIRE(arena.capacity() >= big);
+
+    // small allocations keep working after the oversized block
+    REQUIRE(arena.allocate(16) != nullptr);
+}
+
+TEST_CASE("io::ArenaScope rewinds on scope exit", "[io][arena]") {
+    io::Arena arena;
+    (void)arena.allocate(8);
+
+    void* inside = nullptr;
+    {
+        io::ArenaScope scope{ arena };
+        inside = arena.allocate(64);
+        REQUIRE(inside != nullptr);
+    }
+    REQUIRE(arena.allocate(64) == inside);
+}
+
+TEST_CASE("io::FrameArena keeps the previous frame alive", "[io][arena]") {
+    io::FrameArena<2> frames;
+
+    int* a = frames.current().make<int>(1);
+    frames.next();
+    int* b = frames.current().make<int>(2);
+    REQUIRE(frames.previous().capacity() != 0);
+    REQUIRE(*a == 1); // previous frame still intact
+
+    frames.next(); // back to the first arena, now reset
+    int* c = frames.current().make<int>(3);
+    REQUIRE(c == a);
+    REQUIRE(*b == 2);
+}
+
+TEST_CASE("io::Arena maps blocks with the requested page flags", "[io][arena]") {
+    io::Arena arena(IO_ARENA_BLOCK_BYTES, io::PageFlags::HugePages | io::PageFlags::Prefault);
+    auto* p = static_cast<io::u8*>(arena.allocate(1000));
+    REQUIRE(p != nullptr);
+    p[999] = 1;
+    if (io::huge_page_size()) REQUIRE(arena.capacity() % io::huge_page_size() == 0);
+}
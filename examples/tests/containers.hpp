@@ -3,6 +3,7 @@
 #include "catch.hpp"
 
 #include "../../hi/native/containers.hpp"
+#include "../../hi/native/stable_vector.hpp"
 
 // ---------- helper: lifetime tracker ----------
 struct Tracker {
@@ -112,6 +113,35 @@ TEST_CASE("io::vector resize grows value-initialized and shrinks destroying extr
     REQUIRE(Tracker::dtor >= 12);
 }
 
+TEST_CASE("io::vector of POD grows, zero-fills and overwrites in bulk", "[io][vector]") {
+    struct Pod { io::u32 a; io::u16 b; };
+
+    io::vector<Pod> v;
+    REQUIRE(v.resize(3));
+    v[0] = Pod{ 1, 2 };
+    v[2] = Pod{ 5, 6 };
+
+    // value-initialized tail is zero
+    REQUIRE(v.resize(1000));
+    bool zero = true;
+    for (io::usize i = 3; i < 1000; ++i) zero &= v[i].a == 0 && v[i].b == 0;
+    REQUIRE(zero);
+    REQUIRE(v[2].a == 5);
+
+    // relocation keeps the contents
+    REQUIRE(v.reserve(100000));
+    REQUIRE(v[0].a == 1);
+    REQUIRE(v[2].b == 6);
+
+    // for_overwrite only changes the size
+    REQUIRE(v.resize_for_overwrite(5000));
+    REQUIRE(v.size() == 5000);
+    v[4999] = Pod{ 9, 9 };
+    REQUIRE(v[0].a == 1);
+    REQUIRE(v.resize_for_overwrite(2));
+    REQUIRE(v.size() == 2);
+}
+
 TEST_CASE("io::vector pop_back works and safe on empty", "[io][vector]") {
     Tracker::reset();
     io::vector<Tracker> v;
@@ -176,6 +206,78 @@ TEST_CASE("io::vector as_view points to same data and size", "[io][vector]") {
 }
 
 
+// ============================================================
+//                      small_vector tests
+// ============================================================
+
+TEST_CASE("io::small_vector stays inline up to N then spills", "[io][small_vector]") {
+    io::small_vector<int, 4> v;
+    REQUIRE(v.empty());
+    REQUIRE(v.capacity() == 4);
+    REQUIRE(v.is_inline());
+
+    for (int i = 0; i < 4; ++i) REQUIRE(v.push_back(i));
+    REQUIRE(v.is_inline());
+    REQUIRE(reinterpret_cast<const char*>(v.data()) >= reinterpret_cast<const char*>(&v));
+    REQUIRE(reinterpret_cast<const char*>(v.data()) < reinterpret_cast<const char*>(&v + 1));
+
+    REQUIRE(v.push_back(4));
+    REQUIRE_FALSE(v.is_inline());
+    REQUIRE(v.capacity() >= 5);
+    for (int i = 5; i < 100; ++i) REQUIRE(v.push_back(i));
+
+    const io::small_vector<int, 4>& cv = v;
+    io::view<const int> vw = cv.as_view();
+    REQUIRE(vw.size() == 100);
+    bool ok = true;
+    for (int i = 0; i < 100; ++i) ok &= vw[i] == i;
+    REQUIRE(ok);
+
+    REQUIRE(v.resize(2));
+    REQUIRE(v.back() == 1);
+    v.clear();
+    REQUIRE(v.empty());
+}
+
+TEST_CASE("io::small_vector move keeps elements inline or steals the heap buffer", "[io][small_vector]") {
+    Tracker::reset();
+    {
+        io::small_vector<Tracker, 3> a;
+        REQUIRE(a.push_back(Tracker{ 1 }));
+        REQUIRE(a.push_back(Tracker{ 2 }));
+
+        io::small_vector<Tracker, 3> b(io::move(a));
+        REQUIRE(a.size() == 0);
+        REQUIRE(b.is_inline());
+        REQUIRE(b.size() == 2);
+        REQUIRE(b[1].v == 2);
+        REQUIRE(Tracker::alive == 2);
+
+        for (int i = 3; i <= 6; ++i) REQUIRE(b.push_back(Tracker{ i }));
+        const Tracker* heap = b.data();
+
+        io::small_vector<Tracker, 3> c;
+        REQUIRE(c.push_back(Tracker{ 99 }));
+        c = io::move(b);
+        REQUIRE(c.data() == heap);
+        REQUIRE(c.size() == 6);
+        REQUIRE(b.is_inline());
+        REQUIRE(b.empty());
+        REQUIRE(Tracker::alive == 6);
+    }
+    REQUIRE(Tracker::alive == 0);
+}
+
+TEST_CASE("io::string::split into a small_vector does not allocate for short paths", "[io][small_vector][string]") {
+    io::string path("usr/local/share/hi");
+    io::small_vector<io::char_view, 8> parts;
+    REQUIRE(path.split('/', parts));
+    REQUIRE(parts.is_inline());
+    REQUIRE(parts.size() == 4);
+    REQUIRE(parts[0] == "usr");
+    REQUIRE(parts[3] == "hi");
+}
+
 // ============================================================
 //                       string tests
 // ============================================================
@@ -210,6 +312,38 @@ TEST_CASE("io::string resize grow/shrink", "[io][string]") {
     REQUIRE(s.c_str()[1] == '\0');
 }
 
+TEST_CASE("io::string push_back amortizes growth and bulk appends copy whole runs", "[io][string]") {
+    io::string s;
+    io::usize grows = 0, cap = s.capacity();
+    bool ok = true;
+    for (int i = 0; i < 100000; ++i) {
+        ok &= s.push_back(static_cast<char>('0' + i % 10));
+        if (s.capacity() != cap) { ++grows; cap = s.capacity(); }
+    }
+    REQUIRE(ok);
+    REQUIRE(grows < 20); // doubling, not per character
+    REQUIRE(s[99999] == '9');
+    REQUIRE(s.c_str()[100000] == '\0');
+
+    io::string t("head:");
+    REQUIRE(t.append(io::char_view{ s.data(), 1000 }));
+    REQUIRE(t.size() == 1005);
+    REQUIRE(t[5] == '0');
+    REQUIRE(t[1004] == '9');
+}
+
+TEST_CASE("io::string resize_for_overwrite sizes without filling", "[io][string]") {
+    io::string s("keep");
+    REQUIRE(s.resize_for_overwrite(100));
+    REQUIRE(s.size() == 100);
+    REQUIRE(s.c_str()[100] == '\0');
+    REQUIRE(s[0] == 'k');
+    for (int i = 4; i < 100; ++i) s[i] = 'z';
+
+    REQUIRE(s.resize_for_overwrite(6));
+    REQUIRE(s == io::char_view{ "keepzz", 6 });
+}
+
 TEST_CASE("io::wstring default is empty and nul-terminated", "[io][wstring]") {
     io::wstring ws;
     REQUIRE(ws.size() == 0);
@@ -329,6 +463,26 @@ TEST_CASE("io::deque wrap-around correctness (mixed pushes/pops)", "[io][deque]"
     REQUIRE(d[2] == 10);
 }
 
+TEST_CASE("io::deque grows a wrapped ring of trivial or tracked elements", "[io][deque]") {
+    io::deque<int> d;
+    Tracker::reset();
+    {
+        io::deque<Tracker> t;
+        for (int i = 0; i < 8; ++i) { REQUIRE(d.push_back(i)); REQUIRE(t.push_back(Tracker{ i })); }
+        for (int i = 0; i < 5; ++i) { d.pop_front(); t.pop_front(); }
+        for (int i = 8; i < 13; ++i) { REQUIRE(d.push_back(i)); REQUIRE(t.push_back(Tracker{ i })); } // wraps
+        REQUIRE(d.push_back(13)); // full: grows from a wrapped ring
+        REQUIRE(t.push_back(Tracker{ 13 }));
+
+        for (int i = 0; i < 9; ++i) {
+            REQUIRE(d[(io::usize)i] == 5 + i);
+            REQUIRE(t[(io::usize)i].v == 5 + i);
+        }
+        REQUIRE(Tracker::alive == 9);
+    }
+    REQUIRE(Tracker::alive == 0);
+}
+
 TEST_CASE("io::deque clear destroys elements", "[io][deque]") {
     Tracker::reset();
     io::deque<Tracker> d;
@@ -340,6 +494,58 @@ TEST_CASE("io::deque clear destroys elements", "[io][deque]") {
     REQUIRE(Tracker::alive == 0);
 }
 
+TEST_CASE("io::deque keeps references stable while growing at both ends", "[io][deque]") {
+    io::deque<int> d;
+    REQUIRE(d.push_back(0));
+    int* first = &d.front();
+    bool ok = true;
+    for (int i = 1; i < 5000; ++i) ok &= d.push_back(i) && d.push_front(-i);
+    REQUIRE(ok);
+    REQUIRE(&d[4999] == first);
+    REQUIRE(*first == 0);
+    REQUIRE(d.front() == -4999);
+    REQUIRE(d.back() == 4999);
+    REQUIRE((d.capacity() & (d.capacity() - 1)) == 0);
+
+    for (io::usize i = 0; i < d.size(); ++i) ok &= d[i] == int(i) - 4999;
+    REQUIRE(ok);
+}
+
+TEST_CASE("io::deque push_back_range and pop_front_n cross block boundaries", "[io][deque]") {
+    using D = io::deque<int>;
+    int src[3 * D::BLOCK + 5];
+    for (int i = 0; i < int(sizeof(src) / sizeof(src[0])); ++i) src[i] = i;
+
+    D d;
+    REQUIRE(d.push_back(-1));
+    REQUIRE(d.push_back_range(io::view<const int>{ src }));
+    REQUIRE(d.size() == 1 + 3 * D::BLOCK + 5);
+    REQUIRE(d.pop_front_n(1) == 1);
+
+    int out[D::BLOCK + 3];
+    REQUIRE(d.pop_front_n(out, D::BLOCK + 3) == D::BLOCK + 3);
+    bool ok = true;
+    for (io::usize i = 0; i < D::BLOCK + 3; ++i) ok &= out[i] == int(i);
+    for (io::usize i = 0; i < d.size(); ++i) ok &= d[i] == int(D::BLOCK + 3 + i);
+    REQUIRE(ok);
+
+    REQUIRE(d.pop_front_n(1000000) == 2 * D::BLOCK + 2);
+    REQUIRE(d.empty());
+    REQUIRE(d.pop_front_n(out, 4) == 0);
+
+    Tracker::reset();
+    {
+        io::deque<Tracker> t;
+        Tracker ts[40];
+        for (int i = 0; i < 40; ++i) ts[i].v = i;
+        REQUIRE(t.push_back_range(io::view<const Tracker>{ ts }));
+        REQUIRE(t.pop_front_n(15) == 15);
+        REQUIRE(t.front().v == 15);
+        REQUIRE(Tracker::alive == 40 + 25);
+    }
+    REQUIRE(Tracker::alive == 0);
+}
+
 // ============================================================
 //                         list tests
 // ============================================================
@@ -463,4 +669,317 @@ TEST_CASE("io::list move ctor/assign", "[io][list]") {
     c = io::move(b);
     REQUIRE(c.size() == 4);
     REQUIRE(b.size() == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("io::list recycles nodes from its slabs", "[io][list]") {
+    io::list<int> l;
+    REQUIRE(l.reserve(100));
+    REQUIRE(l.capacity() >= 100);
+    const io::usize cap = l.capacity();
+
+    bool ok = true;
+    for (int round = 0; round < 50; ++round) {
+        for (int i = 0; i < 100; ++i) ok &= l.push_back(i);
+        for (auto it = l.begin(); it != l.end();) it = (*it % 2) ? l.erase(it) : ++it;
+        l.clear();
+    }
+    REQUIRE(ok);
+    REQUIRE(l.capacity() == cap);
+
+    REQUIRE(l.push_back(7));
+    l.shrink_to_fit(); // not empty: keeps the slabs
+    REQUIRE(l.capacity() == cap);
+    l.pop_back();
+    l.shrink_to_fit();
+    REQUIRE(l.capacity() == 0);
+    REQUIRE(l.push_front(8));
+    REQUIRE(l.front() == 8);
+}
+
+struct Timer {
+    int id{ 0 };
+    io::list_hook by_deadline;
+    io::list_hook by_owner;
+};
+
+TEST_CASE("io::intrusive_list links embedded hooks without allocating", "[io][list][intrusive]") {
+    using deadline_list = io::intrusive_list<Timer, &Timer::by_deadline>;
+    using owner_list = io::intrusive_list<Timer, &Timer::by_owner>;
+
+    Timer t[5];
+    for (int i = 0; i < 5; ++i) t[i].id = i;
+
+    deadline_list d;
+    owner_list o;
+    for (int i = 0; i < 5; ++i) d.push_back(t[i]);
+    o.push_front(t[1]);
+    o.push_front(t[3]);
+    REQUIRE(d.size() == 5);
+    REQUIRE(o.size() == 2);
+    REQUIRE(o.front().id == 3);
+    REQUIRE(deadline_list::owner(&t[2].by_deadline) == &t[2]);
+
+    d.erase(t[2]);
+    REQUIRE_FALSE(t[2].by_deadline.linked());
+    REQUIRE(t[1].by_deadline.linked());
+    REQUIRE(t[1].by_owner.linked());
+
+    int expect[] = { 0, 1, 3, 4 };
+    int k = 0;
+    bool ok = true;
+    for (Timer& x : d) ok &= x.id == expect[k++];
+    REQUIRE(ok);
+    REQUIRE(k == 4);
+
+    auto it = d.begin();
+    ++it;
+    d.insert(it, t[2]); // back between 0 and 1
+    REQUIRE((++d.begin())->id == 2);
+    d.pop_front();
+    d.pop_back();
+    REQUIRE(d.front().id == 2);
+    REQUIRE(d.back().id == 3);
+
+    deadline_list moved(io::move(d));
+    REQUIRE(d.empty());
+    REQUIRE(d.begin() == d.end());
+    REQUIRE(moved.size() == 3);
+    REQUIRE(moved.back().id == 3);
+    moved.push_back(t[0]);
+    REQUIRE(moved.back().id == 0);
+
+    moved.clear();
+    REQUIRE_FALSE(t[0].by_deadline.linked());
+    REQUIRE(t[3].by_owner.linked()); // other hook untouched
+}
+// ============================================================
+//                     stable_vector tests
+// ============================================================
+
+TEST_CASE("io::stable_vector default reserves nothing", "[io][stable_vector]") {
+    io::stable_vector<int> v;
+    REQUIRE(v.size() == 0);
+    REQUIRE(v.capacity() == 0);
+    REQUIRE(v.data() == nullptr);
+    REQUIRE(v.max_size() > 0);
+}
+
+TEST_CASE("io::stable_vector grows without moving elements", "[io][stable_vector]") {
+    Tracker::reset();
+    {
+        io::stable_vector<Tracker> v;
+        REQUIRE(v.push_back(Tracker{ 0 }));
+        const Tracker* first = &v[0];
+        const Tracker* base = v.data();
+
+        bool pushed = true;
+        for (int i = 1; i < 100000; ++i) pushed = v.push_back(Tracker{ i }) && pushed;
+        REQUIRE(pushed);
+        REQUIRE(v.size() == 100000);
+        REQUIRE(v.data() == base);  // never relocated
+        REQUIRE(&v[0] == first);
+        REQUIRE(first->v == 0);
+        REQUIRE(v.back().v == 99999);
+        REQUIRE(Tracker::move_ctor == 100000); // only the push itself, no growth moves
+    }
+    REQUIRE(Tracker::alive == 0);
+}
+
+TEST_CASE("io::stable_vector honors max_size and resize", "[io][stable_vector]") {
+    io::stable_vector<io::u64> v(1000);
+    REQUIRE(v.resize(1000));
+    REQUIRE(v[999] == 0);
+    REQUIRE_FALSE(v.push_back(1)); // reservation is full
+    REQUIRE(v.size() == 1000);
+
+    REQUIRE(v.resize(10));
+    REQUIRE(v.size() == 10);
+    v.clear();
+    REQUIRE(v.empty());
+    REQUIRE(v.capacity() >= 1000); // committed pages are kept
+}
+
+TEST_CASE("io::stable_vector move transfers the reservation", "[io][stable_vector]") {
+    io::stable_vector<int> a;
+    for (int i = 0; i < 10; ++i) REQUIRE(a.push_back(i));
+    const int* p = a.data();
+
+    io::stable_vector<int> b(io::move(a));
+    REQUIRE(b.data() == p);
+    REQUIRE(b.size() == 10);
+    REQUIRE(a.size() == 0);
+    REQUIRE(a.data() == nullptr);
+}
+
+// ============================================================
+//                      allocator tests
+// ============================================================
+
+// Counts bytes handed out and returned, forwarding to the heap.
+struct CountingAlloc {
+    io::usize* live{ nullptr };
+
+    IO_NODISCARD void* allocate(io::usize bytes, io::usize align) noexcept {
+        *live += bytes;
+        return io::heap_allocator{}.allocate(bytes, align);
+    }
+    void deallocate(void* p, io::usize bytes, io::usize align) noexcept {
+        *live -= bytes;
+        io::heap_allocator{}.deallocate(p, bytes, align);
+    }
+};
+
+TEST_CASE("io containers with the default allocator add no storage", "[io][allocator]") {
+    REQUIRE(sizeof(io::vector<int>) == 3 * sizeof(void*));
+    REQUIRE(sizeof(io::deque<int>) == 4 * sizeof(void*));
+    REQUIRE(sizeof(io::list<int>) == 6 * sizeof(void*));
+    REQUIRE(sizeof(io::small_vector<void*, 4>) == 7 * sizeof(void*));
+    REQUIRE(sizeof(io::string) == sizeof(io::vector<char>));
+}
+
+TEST_CASE("io containers route every byte through a custom allocator", "[io][allocator]") {
+    io::usize live = 0;
+    CountingAlloc a{ &live };
+    {
+        io::vector<Tracker, CountingAlloc> v(a);
+        io::deque<int, CountingAlloc> d(a);
+        io::list<int, CountingAlloc> l(a);
+        io::basic_string<char, CountingAlloc> s("hello", a);
+
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(v.push_back(Tracker{ i }));
+            REQUIRE(d.push_front(i));
+            REQUIRE(l.push_back(i));
+            REQUIRE(s.push_back('!'));
+        }
+        REQUIRE(live > 0);
+
+        // the allocator moves with the container
+        io::vector<Tracker, CountingAlloc> moved(io::move(v));
+        REQUIRE(moved.get_allocator().live == &live);
+        REQUIRE(moved[99].v == 99);
+    }
+    REQUIRE(live == 0);
+}
+
+TEST_CASE("io::deque reuses its blocks as a FIFO queue", "[io][deque][allocator]") {
+    io::usize live = 0;
+    CountingAlloc a{ &live };
+    {
+        io::deque<io::u64, CountingAlloc> q(a);
+        REQUIRE(q.reserve(1000));
+
+        bool ok = true;
+        io::u64 next = 0, expect = 0;
+        io::usize steady = 0;
+        for (int round = 0; round < 200; ++round) {
+            for (int i = 0; i < 700; ++i) ok &= q.push_back(next++);
+            while (q.size() > 300) { ok &= q.front() == expect++; q.pop_front(); }
+            if (round == 10) steady = live; // the ring has touched every block it needs
+        }
+        REQUIRE(ok);
+        REQUIRE(live == steady);
+    }
+    REQUIRE(live == 0);
+}
+
+TEST_CASE("io::string keeps short strings inline without allocating", "[io][string][allocator]") {
+    using counted_string = io::basic_string<char, CountingAlloc>;
+    io::usize live = 0;
+    CountingAlloc a{ &live };
+    {
+        counted_string empty(a);
+        REQUIRE(empty.c_str()[0] == '\0');
+
+        counted_string s("short", a);
+        for (io::usize i = s.size(); i < counted_string::SSO_CAPACITY; ++i) REQUIRE(s.push_back('.'));
+        REQUIRE(s.size() == counted_string::SSO_CAPACITY);
+        REQUIRE(s.c_str()[s.size()] == '\0');
+        REQUIRE(live == 0);
+
+        // one more spills to the heap, contents intact
+        REQUIRE(s.push_back('!'));
+        REQUIRE(live > 0);
+        REQUIRE(s.size() == counted_string::SSO_CAPACITY + 1);
+        REQUIRE(s.as_view().find(io::char_view{ "short.", 6 }) == 0);
+        REQUIRE(s[s.size() - 1] == '!');
+
+        // moving a short string copies it; the source is left empty
+        counted_string t("tiny", a);
+        counted_string u(io::move(t));
+        REQUIRE(u == io::char_view{ "tiny", 4 });
+        REQUIRE(t.empty());
+        REQUIRE(t.c_str()[0] == '\0');
+
+        // clear keeps the heap buffer; appending itself survives growth
+        s.clear();
+        REQUIRE(s.empty());
+        REQUIRE(s.append("abc"));
+        for (int i = 0; i < 5; ++i) REQUIRE(s.append(s.as_view()));
+        REQUIRE(s.size() == 3 * 32);
+        REQUIRE(s[95] == 'c');
+    }
+    REQUIRE(live == 0);
+
+    REQUIRE(sizeof(io::string) == 3 * sizeof(void*));
+    io::wstring w(L"wide");
+    REQUIRE(w.size() == 4);
+    REQUIRE(w.capacity() == io::wstring::SSO_CAPACITY);
+}
+
+TEST_CASE("io::vector grows trivially relocatable elements through reallocate", "[io][allocator]") {
+    REQUIRE(io::is_trivially_relocatable_v<int>);
+    REQUIRE(!io::is_trivially_relocatable_v<io::string>);
+    REQUIRE(io::has_reallocate<io::heap_allocator>::value);
+    REQUIRE(!io::has_reallocate<io::arena_allocator>::value);
+
+    // well past the large-block threshold, so growth takes the remap path
+    io::vector<io::u32> v;
+    const io::u32 n = 1u << 20;
+    bool ok = true;
+    for (io::u32 i = 0; i < n; ++i) ok &= v.push_back(i * 7u);
+    REQUIRE(ok);
+    REQUIRE(v.size() == n);
+    for (io::u32 i = 0; i < n; ++i) ok &= v[i] == i * 7u;
+    REQUIRE(ok);
+
+    io::string s;
+    for (int i = 0; i < 300000; ++i) ok &= s.push_back(static_cast<char>('a' + i % 26));
+    REQUIRE(ok);
+    REQUIRE(s.size() == 300000);
+    REQUIRE(s[299999] == static_cast<char>('a' + 299999 % 26));
+    REQUIRE(s.c_str()[300000] == '\0');
+}
+
+TEST_CASE("io::vector of over-aligned elements keeps every element aligned", "[io][allocator]") {
+    struct alignas(64) Line { io::u32 v; };
+
+    io::vector<Line> v;
+    bool ok = true;
+    for (io::u32 i = 0; i < 5000; ++i) {
+        ok &= v.push_back(Line{ i });
+        ok &= reinterpret_cast<io::usize>(v.data()) % 64 == 0;
+    }
+    REQUIRE(ok);
+    REQUIRE(v[4999].v == 4999);
+}
+
+TEST_CASE("io::vector and io::string allocate from an io::Arena", "[io][allocator][arena]") {
+    io::Arena arena;
+    {
+        io::ArenaScope scope{ arena };
+        io::vector<int, io::arena_allocator> v{ io::arena_allocator{ arena } };
+        for (int i = 0; i < 1000; ++i) REQUIRE(v.push_back(i));
+        REQUIRE(v[999] == 999);
+        REQUIRE(arena.capacity() > 0);
+
+        io::basic_string<char, io::arena_allocator> s("frame ", arena);
+        REQUIRE(s.append("scratch"));
+        REQUIRE(s == io::char_view{ "frame scratch", 13 });
+    }
+    // everything went back with the scope; blocks stay mapped
+    const io::usize cap = arena.capacity();
+    io::vector<int, io::arena_allocator> w{ io::arena_allocator{ arena } };
+    for (int i = 0; i < 1000; ++i) REQUIRE(w.push_back(i));
+    REQUIRE(arena.capacity() == cap);
+}
@@ -0,0 +1,118 @@
+#pragma once
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../../hi/native/hash.hpp"
+#include "../../hi/native/hash_map.hpp"
+
+// ============================================================
+//                         Byte hashing
+// ============================================================
+
+namespace {
+    // Deterministic filler so lengths cross every path boundary.
+    void fill_pattern(io::u8* p, io::usize n) noexcept {
+        io::u64 x = 0x243f6a8885a308d3ull;
+        for (io::usize i = 0; i < n; ++i) {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+            p[i] = static_cast<io::u8>(x >> 56);
+        }
+    }
+
+    // 300 bytes: the long path with a partial final stripe.
+    constexpr char LONG_KEY[] =
+        "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ-_"
+        "the quick brown fox jumps over the lazy dog, again and again and"
+        "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ-_"
+        "the quick brown fox jumps over the lazy dog, again and again and"
+        "!!!! forty-four bytes of tail to finish !!!!";
+}
+
+TEST_CASE("io::hash is deterministic and seed dependent", "[io][hash]") {
+    static io::u8 buf[5000];
+    fill_pattern(buf, sizeof(buf));
+
+    bool ok = true;
+    for (io::usize n = 0; n < sizeof(buf); n += (n < 300 ? 1 : 97)) {
+        const io::u64 h = io::hash::bytes(buf, n);
+        ok &= h == io::hash::of(io::byte_view{ buf, n });
+        ok &= h != io::hash::bytes(buf, n, 1);
+        if (n) ok &= h != io::hash::bytes(buf, n - 1);
+    }
+    REQUIRE(ok);
+}
+
+TEST_CASE("io::hash flips about half the bits for a one-bit change", "[io][hash]") {
+    static io::u8 buf[2048];
+    fill_pattern(buf, sizeof(buf));
+
+    const io::usize lens[] = { 3, 8, 16, 40, 128, 129, 1500 };
+    for (io::usize n : lens) {
+        const io::u64 base = io::hash::bytes(buf, n);
+        io::usize flipped = 0, trials = 0;
+        for (io::usize bit = 0; bit < n * 8; bit += (n < 64 ? 1 : 61)) {
+            buf[bit / 8] ^= io::u8(1u << (bit % 8));
+            io::u64 d = base ^ io::hash::bytes(buf, n);
+            buf[bit / 8] ^= io::u8(1u << (bit % 8));
+            for (; d; d &= d - 1) ++flipped;
+            ++trials;
+        }
+        const double avg = double(flipped) / double(trials);
+        REQUIRE(avg > 24.0);
+        REQUIRE(avg < 40.0);
+    }
+}
+
+TEST_CASE("io::hash short keys do not collide", "[io][hash]") {
+    io::hash_set<io::u64> seen;
+    REQUIRE(seen.reserve(65536 + 256));
+    bool ok = true;
+    for (int i = 0; i < 256; ++i) {
+        const io::u8 one[1] = { io::u8(i) };
+        ok &= seen.insert(io::hash::bytes(one, 1)) != nullptr;
+    }
+    for (int i = 0; i < 65536; ++i) {
+        const io::u8 two[2] = { io::u8(i), io::u8(i >> 8) };
+        ok &= seen.insert(io::hash::bytes(two, 2)) != nullptr;
+    }
+    REQUIRE(ok);
+    REQUIRE(seen.size() == 65536 + 256);
+}
+
+TEST_CASE("io::hash constexpr matches run time", "[io][hash]") {
+    constexpr io::u64 short_key = io::hash::of(io::char_view("connection"));
+    constexpr io::u64 mid_key = io::hash::of(io::char_view("/usr/share/hi/assets/textures/atlas.png"), 7);
+    constexpr io::u64 long_key = io::hash::of(io::char_view(LONG_KEY));
+    static_assert(short_key != mid_key, "distinct keys");
+
+    const char* rt_short = "connection";
+    REQUIRE(io::hash::bytes(rt_short, 10) == short_key);
+    REQUIRE(io::hash::of(io::char_view("/usr/share/hi/assets/textures/atlas.png"), 7) == mid_key);
+    // the run-time long path is vectorized; the constexpr one is scalar
+    REQUIRE(io::hash::bytes(LONG_KEY, sizeof(LONG_KEY) - 1) == long_key);
+}
+
+TEST_CASE("io::hash::stream matches one-shot for any split", "[io][hash]") {
+    static io::u8 buf[3000];
+    fill_pattern(buf, sizeof(buf));
+
+    const io::usize lens[] = { 0, 1, 15, 16, 17, 128, 129, 255, 256, 257, 320, 1024, 1025, 2999 };
+    const io::usize chunks[] = { 1, 7, 64, 100, 256, 257, 3000 };
+    bool ok = true;
+    for (io::usize n : lens) {
+        const io::u64 want = io::hash::bytes(buf, n, 42);
+        for (io::usize c : chunks) {
+            io::hash::stream s(42);
+            for (io::usize at = 0; at < n; at += c) s.update(buf + at, (n - at) < c ? (n - at) : c);
+            ok &= s.digest() == want;
+        }
+    }
+    REQUIRE(ok);
+
+    io::hash::stream s;
+    s.update(io::char_view("hello "));
+    s.update(io::char_view("world"));
+    REQUIRE(s.digest() == io::hash::of(io::char_view("hello world")));
+    s.reset();
+    REQUIRE(s.digest() == io::hash::bytes(nullptr, 0));
+}
@@ -0,0 +1,151 @@
+#pragma once
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../../hi/native/hash_map.hpp"
+
+// ============================================================
+//                        hash_map tests
+// ============================================================
+
+TEST_CASE("io::hash_map default is empty", "[io][hash_map]") {
+    io::hash_map<int, int> m;
+    REQUIRE(m.size() == 0);
+    REQUIRE(m.empty());
+    REQUIRE(m.capacity() == 0);
+    REQUIRE(m.find(1) == nullptr);
+    REQUIRE_FALSE(m.erase(1));
+    REQUIRE(m.begin() == m.end());
+}
+
+TEST_CASE("io::hash_map insert, find and overwrite", "[io][hash_map]") {
+    io::hash_map<io::u64, io::u64> m;
+    bool ok = true;
+    for (io::u64 i = 0; i < 10000; ++i) ok &= m.try_emplace(i, i * 3) != nullptr;
+    REQUIRE(ok);
+    REQUIRE(m.size() == 10000);
+    REQUIRE((m.capacity() & (m.capacity() - 1)) == 0);
+    REQUIRE(m.size() * 8 <= m.capacity() * 7);
+
+    for (io::u64 i = 0; i < 10000; ++i) ok &= m.find(i) && *m.find(i) == i * 3;
+    REQUIRE(ok);
+    REQUIRE(m.find(io::u64(10000)) == nullptr);
+
+    // try_emplace keeps the existing value, insert_or_assign replaces it
+    REQUIRE(*m.try_emplace(io::u64(5), io::u64(0)) == 15);
+    REQUIRE(*m.insert_or_assign(io::u64(5), io::u64(7)) == 7);
+    REQUIRE(m.size() == 10000);
+
+    io::u64 sum = 0;
+    io::usize n = 0;
+    for (auto& e : m) { sum += e.key; ++n; }
+    REQUIRE(n == 10000);
+    REQUIRE(sum == 9999ull * 10000ull / 2);
+}
+
+TEST_CASE("io::hash_map erase without tombstones", "[io][hash_map]") {
+    io::hash_map<int, int> m;
+    REQUIRE(m.reserve(1000));
+    const io::usize cap = m.capacity();
+    REQUIRE(cap >= 1000);
+
+    // Churn far more keys than the capacity through a fixed-size window:
+    // deletion must leave nothing behind that forces a rehash.
+    bool ok = true;
+    for (int i = 0; i < 100000; ++i) {
+        ok &= m.try_emplace(i, i) != nullptr;
+        if (i >= 500) ok &= m.erase(i - 500);
+    }
+    REQUIRE(ok);
+    REQUIRE(m.size() == 500);
+    REQUIRE(m.capacity() == cap);
+
+    for (int i = 0; i < 100000; ++i) ok &= (m.find(i) != nullptr) == (i >= 100000 - 500);
+    REQUIRE(ok);
+
+    m.clear();
+    REQUIRE(m.empty());
+    REQUIRE(m.capacity() == cap);
+    REQUIRE(m.find(99999) == nullptr);
+}
+
+TEST_CASE("io::hash_map string keys are found by view", "[io][hash_map][string]") {
+    io::hash_map<io::string, int> m;
+    REQUIRE(m.try_emplace(io::char_view("alpha"), 1));
+    REQUIRE(m.try_emplace("beta", 2));
+    REQUIRE(m.try_emplace(io::string("a much longer key that spills to the heap"), 3));
+
+    REQUIRE(m.size() == 3);
+    REQUIRE(m.contains("alpha"));
+    REQUIRE(*m.find(io::char_view("beta")) == 2);
+    REQUIRE(*m.find("a much longer key that spills to the heap") == 3);
+    REQUIRE(m.find("gamma") == nullptr);
+
+    const char buf[] = { 'b', 'e', 't', 'a', 'x' };
+    REQUIRE(*m.find(io::char_view(buf, 4)) == 2);
+    REQUIRE(m.erase(io::char_view(buf, 4)));
+    REQUIRE_FALSE(m.contains("beta"));
+
+    io::hash_map<io::string, int> moved(io::move(m));
+    REQUIRE(m.empty());
+    REQUIRE(moved.size() == 2);
+    REQUIRE(*moved.find("alpha") == 1);
+}
+
+namespace {
+    struct HashTracker {
+        static int alive;
+        int v;
+        explicit HashTracker(int x) noexcept : v(x) { ++alive; }
+        HashTracker(HashTracker&& o) noexcept : v(o.v) { ++alive; }
+        HashTracker& operator=(HashTracker&& o) noexcept { v = o.v; return *this; }
+        ~HashTracker() noexcept { --alive; }
+    };
+    int HashTracker::alive = 0;
+
+    // Every key lands in the same group, so erase has to shift whole runs.
+    struct collide_hash {
+        io::u64 operator()(int k) const noexcept { return io::u64(k & 3) << 7; }
+    };
+}
+
+TEST_CASE("io::hash_map erase shifts colliding runs back", "[io][hash_map]") {
+    HashTracker::alive = 0;
+    {
+        io::hash_map<int, HashTracker, collide_hash> m;
+        bool ok = true;
+        for (int i = 0; i < 200; ++i) ok &= m.try_emplace(i, i * 2) != nullptr;
+        for (int i = 0; i < 200; i += 3) ok &= m.erase(i);
+        REQUIRE(ok);
+        REQUIRE(HashTracker::alive == int(m.size()));
+
+        for (int i = 0; i < 200; ++i) {
+            const HashTracker* t = m.find(i);
+            ok &= (i % 3 == 0) ? t == nullptr : (t && t->v == i * 2);
+        }
+        REQUIRE(ok);
+    }
+    REQUIRE(HashTracker::alive == 0);
+}
+
+TEST_CASE("io::hash_set insert, contains and erase", "[io][hash_set]") {
+    io::hash_set<io::string> s;
+    REQUIRE(s.insert("x"));
+    const io::string* first = s.insert(io::char_view("x"));
+    REQUIRE(first);
+    REQUIRE(s.size() == 1);
+    REQUIRE(s.insert("y"));
+    REQUIRE(s.contains(io::char_view("y")));
+    REQUIRE(s.erase("x"));
+    REQUIRE_FALSE(s.contains("x"));
+
+    io::usize n = 0;
+    for (const io::string& k : s) { REQUIRE(k == io::char_view("y")); ++n; }
+    REQUIRE(n == 1);
+
+    io::hash_set<const void*> ptrs;
+    int a, b;
+    REQUIRE(ptrs.insert(static_cast<const void*>(&a)));
+    REQUIRE(ptrs.contains(static_cast<const void*>(&a)));
+    REQUIRE_FALSE(ptrs.contains(static_cast<const void*>(&b)));
+}
@@ -0,0 +1,84 @@
+#pragma once
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../../hi/native/mem.hpp"
+
+// ============================================================
+//                      Memory primitives
+// ============================================================
+
+namespace {
+    void fill_bytes(io::u8* p, io::usize n, io::u32 seed) {
+        for (io::usize i = 0; i < n; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            p[i] = static_cast<io::u8>(seed >> 24);
+        }
+    }
+
+    int sign(int x) { return (x > 0) - (x < 0); }
+}
+
+TEST_CASE("io::mem::copy and set cover every size class and alignment", "[io][mem]") {
+    io::u8 src[320], dst[340], ref[340];
+    fill_bytes(src, sizeof(src), 1);
+    bool ok = true;
+    for (io::usize off = 0; off < 9; ++off) {
+        for (io::usize n = 0; n <= 300; ++n) {
+            fill_bytes(dst, sizeof(dst), 2);
+            fill_bytes(ref, sizeof(ref), 2);
+            for (io::usize i = 0; i < n; ++i) ref[off + i] = src[(off * 3) % 8 + i];
+            ok &= io::mem::copy(dst + off, src + (off * 3) % 8, n) == dst + off;
+            for (io::usize i = 0; i < sizeof(dst); ++i) ok &= dst[i] == ref[i]; // guard bytes untouched
+
+            for (io::usize i = 0; i < n; ++i) ref[off + i] = 0xA5;
+            io::mem::set(dst + off, 0xA5, n);
+            for (io::usize i = 0; i < sizeof(dst); ++i) ok &= dst[i] == ref[i];
+        }
+    }
+    REQUIRE(ok);
+}
+
+TEST_CASE("io::mem::move handles overlap in both directions", "[io][mem]") {
+    io::u8 buf[400], ref[400];
+    bool ok = true;
+    for (io::usize n = 0; n <= 260; n += (n < 70 ? 1 : 13)) {
+        for (io::usize shift = 1; shift <= 40; shift += (shift < 9 ? 1 : 15)) {
+            // destination above the source (backward), then below it (forward)
+            for (int dir = 0; dir < 2; ++dir) {
+                const io::usize s = dir ? 50 + shift : 50;
+                const io::usize d = dir ? 50 : 50 + shift;
+                fill_bytes(buf, sizeof(buf), static_cast<io::u32>(n));
+                for (io::usize i = 0; i < sizeof(buf); ++i) ref[i] = buf[i];
+                io::u8 tmp[400];
+                for (io::usize i = 0; i < n; ++i) tmp[i] = buf[s + i];
+                for (io::usize i = 0; i < n; ++i) ref[d + i] = tmp[i];
+
+                io::mem::move(buf + d, buf + s, n);
+                for (io::usize i = 0; i < sizeof(buf); ++i) ok &= buf[i] == ref[i];
+            }
+        }
+    }
+    REQUIRE(ok);
+}
+
+TEST_CASE("io::mem::compare orders by the first differing unsigned byte", "[io][mem]") {
+    io::u8 a[200], b[200];
+    fill_bytes(a, sizeof(a), 5);
+    bool ok = true;
+    for (io::usize n = 0; n <= 150; ++n) {
+        for (io::usize i = 0; i < sizeof(a); ++i) b[i] = a[i];
+        ok &= io::mem::compare(a, b, n) == 0;
+        for (io::usize at = 0; at < n; at += 3) {
+            b[at] = static_cast<io::u8>(a[at] ^ 0x80); // also checks unsigned ordering
+            const int want = a[at] < b[at] ? -1 : 1;
+            ok &= sign(io::mem::compare(a, b, n)) == want;
+            ok &= sign(io::mem::compare(b, a, n)) == -want;
+            b[n - 1] ^= 1; // a later difference must not win
+            ok &= sign(io::mem::compare(a, b, n)) == want || at == n - 1;
+            b[n - 1] = a[n - 1];
+            b[at] = a[at];
+        }
+    }
+    REQUIRE(ok);
+}
@@ -0,0 +1,259 @@
+#pragma once
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../../hi/native/queue.hpp"
+
+#include <thread> // stress tests only
+
+// ============================================================
+//                        spsc_ring tests
+// ============================================================
+
+TEST_CASE("io::spsc_ring rounds capacity up and rejects when full", "[io][queue][spsc]") {
+    io::spsc_ring<int> q;
+    REQUIRE(q.capacity() == 0);
+    int out = 0;
+    REQUIRE_FALSE(q.try_push(1));
+    REQUIRE_FALSE(q.try_pop(out));
+
+    REQUIRE(q.init(5));
+    REQUIRE_FALSE(q.init(16)); // only once
+    REQUIRE(q.capacity() == 8);
+
+    bool ok = true;
+    for (int i = 0; i < 8; ++i) ok &= q.try_push(i);
+    REQUIRE(ok);
+    REQUIRE_FALSE(q.try_push(8));
+    REQUIRE(q.size_approx() == 8);
+
+    for (int i = 0; i < 8; ++i) ok &= q.try_pop(out) && out == i;
+    REQUIRE(ok);
+    REQUIRE_FALSE(q.try_pop(out));
+    REQUIRE(q.size_approx() == 0);
+}
+
+TEST_CASE("io::spsc_ring push_n / pop_n wrap around the end", "[io][queue][spsc]") {
+    io::spsc_ring<io::u32> q;
+    REQUIRE(q.init(16));
+
+    io::u32 src[16], dst[16];
+    io::u32 next_in = 0, next_out = 0;
+    bool ok = true;
+    // batch sizes coprime to the capacity walk the seam through every slot
+    for (int round = 0; round < 200; ++round) {
+        const io::usize want = 1 + io::usize(round % 7);
+        for (io::usize i = 0; i < want; ++i) src[i] = next_in + io::u32(i);
+        const io::usize pushed = q.push_n(src, want);
+        next_in += io::u32(pushed);
+
+        const io::usize got = q.pop_n(dst, 1 + io::usize(round % 5));
+        for (io::usize i = 0; i < got; ++i) ok &= dst[i] == next_out++;
+    }
+    REQUIRE(ok);
+
+    // fill to the brim: push_n stops at capacity
+    const io::usize room = q.capacity() - q.size_approx();
+    for (io::usize i = 0; i < 16; ++i) src[i] = next_in + io::u32(i);
+    REQUIRE(q.push_n(io::view<const io::u32>(src, 16)) == room);
+    next_in += io::u32(room);
+    REQUIRE(q.push_n(src, 1) == 0);
+
+    while (io::usize got = q.pop_n(dst, 16))
+        for (io::usize i = 0; i < got; ++i) ok &= dst[i] == next_out++;
+    REQUIRE(ok);
+    REQUIRE(next_out == next_in);
+}
+
+namespace {
+    struct RingTracker {
+        static int alive;
+        int v;
+        RingTracker() noexcept : v(-1) { ++alive; }
+        explicit RingTracker(int x) noexcept : v(x) { ++alive; }
+        RingTracker(const RingTracker& o) noexcept : v(o.v) { ++alive; }
+        RingTracker(RingTracker&& o) noexcept : v(o.v) { o.v = -1; ++alive; }
+        RingTracker& operator=(RingTracker&& o) noexcept { v = o.v; o.v = -1; return *this; }
+        ~RingTracker() noexcept { --alive; }
+    };
+    int RingTracker::alive = 0;
+}
+
+TEST_CASE("io::spsc_ring destroys what it still holds", "[io][queue][spsc]") {
+    RingTracker::alive = 0;
+    {
+        io::spsc_ring<RingTracker> q;
+        REQUIRE(q.init(4));
+        REQUIRE(q.try_push(RingTracker(1)));
+        REQUIRE(q.try_push(RingTracker(2)));
+        REQUIRE(RingTracker::alive == 2);
+
+        RingTracker out;
+        REQUIRE(q.try_pop(out));
+        REQUIRE(out.v == 1);
+        REQUIRE(RingTracker::alive == 2); // `out` + one queued
+
+        REQUIRE(q.try_push(RingTracker(3)));
+        REQUIRE(q.try_push(RingTracker(4)));
+        REQUIRE(q.try_push(RingTracker(5))); // wraps
+        REQUIRE(RingTracker::alive == 5);
+    }
+    REQUIRE(RingTracker::alive == 0);
+}
+
+// One producer streams an increasing sequence in mixed single / batch
+// pushes through a deliberately tiny ring; the consumer checks it sees
+// every value exactly once, in order.
+TEST_CASE("io::spsc_ring delivers in order across threads", "[io][queue][spsc][stress]") {
+    io::spsc_ring<io::u64> q;
+    REQUIRE(q.init(64));
+    const io::u64 total = 2000000;
+
+    std::thread producer([&q, total] {
+        io::u64 batch[13];
+        io::u64 next = 0;
+        while (next < total) {
+            if (next & 1) {
+                if (q.try_push(next)) ++next;
+                else std::this_thread::yield();
+                continue;
+            }
+            io::usize n = 0;
+            for (; n < 13 && next + n < total; ++n) batch[n] = next + n;
+            const io::usize pushed = q.push_n(batch, n);
+            if (!pushed) std::this_thread::yield();
+            next += pushed;
+        }
+    });
+
+    io::u64 expect = 0, errors = 0, buf[32];
+    while (expect < total) {
+        io::usize got = 0;
+        if (expect & 1) {
+            got = q.try_pop(buf[0]) ? 1 : 0;
+        } else {
+            got = q.pop_n(buf, 32);
+        }
+        if (!got) { std::this_thread::yield(); continue; }
+        for (io::usize i = 0; i < got; ++i) errors += buf[i] != expect++;
+    }
+    producer.join();
+
+    REQUIRE(errors == 0);
+    REQUIRE(q.size_approx() == 0);
+}
+
+// ============================================================
+//                        mpmc_queue tests
+// ============================================================
+
+TEST_CASE("io::mpmc_queue is FIFO and bounded", "[io][queue][mpmc]") {
+    io::mpmc_queue<int> q;
+    int out = 0;
+    REQUIRE(q.capacity() == 0);
+    REQUIRE_FALSE(q.try_push(1));
+    REQUIRE_FALSE(q.try_pop(out));
+
+    REQUIRE(q.init(1));
+    REQUIRE(q.capacity() == 2); // one slot cannot tell full from empty
+    REQUIRE_FALSE(q.init(8));
+
+    bool ok = true;
+    // several laps so every slot's sequence number wraps around
+    for (int lap = 0; lap < 5; ++lap) {
+        ok &= q.try_push(lap * 2) && q.try_push(lap * 2 + 1);
+        ok &= !q.try_push(-1);
+        ok &= q.size_approx() == 2;
+        ok &= q.try_pop(out) && out == lap * 2;
+        ok &= q.try_pop(out) && out == lap * 2 + 1;
+        ok &= !q.try_pop(out);
+    }
+    REQUIRE(ok);
+}
+
+TEST_CASE("io::mpmc_queue destroys what it still holds", "[io][queue][mpmc]") {
+    RingTracker::alive = 0;
+    {
+        io::mpmc_queue<RingTracker> q;
+        REQUIRE(q.init(4));
+        RingTracker keep(7);
+        REQUIRE(q.try_push(keep)); // copy
+        REQUIRE(keep.v == 7);
+        REQUIRE(q.try_push(RingTracker(8)));
+        REQUIRE(RingTracker::alive == 3);
+
+        RingTracker out;
+        REQUIRE(q.try_pop(out));
+        REQUIRE(out.v == 7);
+        REQUIRE(RingTracker::alive == 3); // keep + out + one queued
+    }
+    REQUIRE(RingTracker::alive == 0);
+}
+
+// Producers push (id << 32 | seq); every consumer checks that each
+// producer's values arrive in increasing order, and the grand total
+// proves nothing was lost or duplicated.
+static bool mpmc_stress(io::mpmc_queue<io::u64>& q, int producers, int consumers,
+                        io::u64 per_producer, bool blocking) {
+    io::atomic<io::u64> sum{ 0 };
+    io::atomic<int> misordered{ 0 };
+    std::thread workers[16];
+    const io::u64 total = per_producer * io::u64(producers);
+    io::atomic<io::u64> taken{ 0 };
+
+    for (int p = 0; p < producers; ++p) {
+        workers[p] = std::thread([&q, p, per_producer, blocking] {
+            for (io::u64 i = 0; i < per_producer; ++i) {
+                const io::u64 v = (io::u64(p) << 32) | i;
+                if (blocking) q.push(v);
+                else while (!q.try_push(v)) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        workers[producers + c] = std::thread([&, blocking] {
+            io::u64 last[8];
+            for (io::u64& l : last) l = ~0ull;
+            io::u64 local = 0;
+            // claim a ticket first so exactly `total` pops happen overall
+            while (taken.fetch_add(1) < total) {
+                io::u64 v;
+                if (blocking) q.pop(v);
+                else while (!q.try_pop(v)) std::this_thread::yield();
+                const io::u64 id = v >> 32, seq = v & 0xffffffffull;
+                if (last[id] != ~0ull && seq <= last[id]) (void)misordered.fetch_add(1);
+                last[id] = seq;
+                local += seq;
+            }
+            (void)sum.fetch_add(local);
+        });
+    }
+    for (int t = 0; t < producers + consumers; ++t) workers[t].join();
+
+    const io::u64 want = io::u64(producers) * (per_producer * (per_producer - 1) / 2);
+    return misordered.load() == 0 && sum.load() == want && q.size_approx() == 0;
+}
+
+TEST_CASE("io::mpmc_queue try_push / try_pop across threads", "[io][queue][mpmc][stress]") {
+    io::mpmc_queue<io::u64> q;
+    REQUIRE(q.init(256));
+    REQUIRE(mpmc_stress(q, 4, 4, 100000, false));
+}
+
+TEST_CASE("io::mpmc_queue blocking push / pop park instead of spinning", "[io][queue][mpmc][stress]") {
+    // a tiny queue keeps both sides parking on the futex all the time
+    io::mpmc_queue<io::u64> q;
+    REQUIRE(q.init(4));
+    REQUIRE(mpmc_stress(q, 3, 5, 50000, true));
+}
+
+TEST_CASE("io::mpmc_queue pop wakes when a value arrives later", "[io][queue][mpmc]") {
+    io::mpmc_queue<int> q;
+    REQUIRE(q.init(8));
+    int got = 0;
+    std::thread consumer([&q, &got] { q.pop(got); });
+    io::sleep_ms(20); // let the consumer park
+    q.push(42);
+    consumer.join();
+    REQUIRE(got == 42);
+}
@@ -0,0 +1,139 @@
+#pragma once
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../../hi/native/search.hpp"
+#include "../../hi/native/containers.hpp"
+
+// ============================================================
+//                      Search kernels
+// ============================================================
+
+namespace {
+    // Reference results, one element at a time.
+    io::usize naive_find(const io::u8* p, io::usize n, const io::u8* needle, io::usize m) {
+        if (m == 0) return 0;
+        for (io::usize i = 0; i + m <= n; ++i) {
+            io::usize j = 0;
+            while (j < m && p[i + j] == needle[j]) ++j;
+            if (j == m) return i;
+        }
+        return io::native::NOT_FOUND;
+    }
+
+    io::usize naive_find_any(const io::u8* p, io::usize n, const io::u8* set, io::usize set_n) {
+        for (io::usize i = 0; i < n; ++i)
+            for (io::usize k = 0; k < set_n; ++k)
+                if (p[i] == set[k]) return i;
+        return io::native::NOT_FOUND;
+    }
+
+    // Small alphabet so matches and near-misses are frequent.
+    void fill_pattern(io::u8* p, io::usize n, io::u32 seed) {
+        for (io::usize i = 0; i < n; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            p[i] = static_cast<io::u8>('a' + (seed >> 24) % 4);
+        }
+    }
+}
+
+TEST_CASE("io::native::find_byte matches a scalar scan at every length and offset", "[io][search]") {
+    io::u8 buf[200];
+    fill_pattern(buf, sizeof(buf), 7);
+    bool ok = true;
+    for (io::usize off = 0; off < 8; ++off) {
+        for (io::usize n = 0; n + off <= sizeof(buf); ++n) {
+            for (io::u8 b = 'a'; b <= 'e'; ++b) // 'e' never occurs
+                ok &= io::native::find_byte(buf + off, n, b) == naive_find(buf + off, n, &b, 1);
+        }
+    }
+    REQUIRE(ok);
+
+    // hit in the last byte and in an overlapping tail block
+    io::u8 zeros[70] = {};
+    zeros[69] = 1;
+    REQUIRE(io::native::find_byte(zeros, 70, 1) == 69);
+    REQUIRE(io::native::find_byte(zeros, 69, 1) == io::native::NOT_FOUND);
+}
+
+TEST_CASE("io::native::find_bytes matches a naive substring search", "[io][search]") {
+    io::u8 hay[300];
+    fill_pattern(hay, sizeof(hay), 11);
+    bool ok = true;
+    for (io::usize m = 0; m <= 12; ++m) {
+        for (io::usize start = 0; start + m <= sizeof(hay); start += 13) {
+            const io::u8* needle = hay + start; // guaranteed to occur
+            for (io::usize n = m; n <= sizeof(hay); n += 7)
+                ok &= io::native::find_bytes(hay, n, needle, m) == naive_find(hay, n, needle, m);
+        }
+    }
+    REQUIRE(ok);
+
+    const io::u8 absent[] = { 'a', 'b', 'z' };
+    REQUIRE(io::native::find_bytes(hay, sizeof(hay), absent, 3) == io::native::NOT_FOUND);
+    REQUIRE(io::native::find_bytes(hay, 2, absent, 3) == io::native::NOT_FOUND);
+}
+
+TEST_CASE("io::native::find_any_byte handles small and large delimiter sets", "[io][search]") {
+    io::u8 buf[150];
+    fill_pattern(buf, sizeof(buf), 3);
+    buf[97] = ',';
+
+    const io::u8 small[] = { ',', 'x', 'd' };
+    io::u8 large[20];
+    for (io::u8 i = 0; i < 20; ++i) large[i] = static_cast<io::u8>('A' + i); // none occur
+    large[19] = ',';
+
+    bool ok = true;
+    for (io::usize n = 0; n <= sizeof(buf); ++n) {
+        ok &= io::native::find_any_byte(buf, n, small, 3) == naive_find_any(buf, n, small, 3);
+        ok &= io::native::find_any_byte(buf, n, large, 20) == naive_find_any(buf, n, large, 20);
+        ok &= io::native::find_any_byte(buf, n, small, 0) == io::native::NOT_FOUND;
+    }
+    REQUIRE(ok);
+    REQUIRE(io::native::find_any_byte(buf, sizeof(buf), large, 20) == 97);
+}
+
+TEST_CASE("io::view find/find_first_of use the kernels and keep positions", "[io][search][view]") {
+    const char text[] = "GET /index.html HTTP/1.1\r\nHost: example.org\r\n\r\nbody";
+    io::char_view v{ text };
+
+    REQUIRE(v.find('H') == 16);
+    REQUIRE(v.find('H', 17) == 26);
+    REQUIRE(v.find(io::char_view{ "\r\n\r\n" }) == 43);
+    REQUIRE(v.find(io::char_view{ "HTTP" }, 17) == io::char_view::npos);
+    REQUIRE(v.find_first_of(io::char_view{ " \r\n" }, 4) == 15);
+    REQUIRE(v.find_first_of(io::char_view{ "#" }) == io::char_view::npos);
+
+    // non-byte views keep the generic loops
+    const int xs[] = { 5, 6, 7, 8 };
+    io::view<const int> iv{ xs };
+    REQUIRE(iv.find(7) == 2);
+    REQUIRE(iv.find_first_of(io::view<const int>{ xs + 3, 1 }) == 3);
+
+    // still usable at compile time
+    static constexpr char lit[] = "a,b";
+    STATIC_REQUIRE(io::char_view{ lit }.find(',') == 1);
+}
+
+TEST_CASE("io::string split finds delimiters across long inputs", "[io][search][string]") {
+    io::string s;
+    bool ok = true;
+    for (int i = 0; i < 1000; ++i) {
+        ok &= s.append("field");
+        if (i != 999) ok &= s.push_back(';');
+    }
+    REQUIRE(ok);
+
+    io::vector<io::string::view_t> parts;
+    REQUIRE(s.split(';', parts));
+    REQUIRE(parts.size() == 1000);
+    REQUIRE(parts[0] == io::char_view{ "field" });
+    REQUIRE(parts[999] == io::char_view{ "field" });
+
+    io::string edge(";x;");
+    REQUIRE(edge.split(';', parts));
+    REQUIRE(parts.size() == 3);
+    REQUIRE(parts[0].size() == 0);
+    REQUIRE(parts[2].size() == 0);
+}
@@ -0,0 +1,457 @@
+#pragma once
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../../hi/native/slot_alloc.hpp"
+
+#include <thread> // stress tests only
+
+#ifndef _WIN32
+#  include <signal.h>
+#  include <unistd.h>
+#  include <sys/wait.h>
+#endif
+
+// ============================================================
+//                       SlotPool tests
+// ============================================================
+
+TEST_CASE("io::native::SlotPool refill carves one slab into many slots", "[io][slot_alloc][slab]") {
+    io::native::SlotPool<64, 64 * 1024> pool;
+
+    void* first = pool.allocate();
+    REQUIRE(first != nullptr);
+
+    // next slots come from the same slab, not from new mappings
+    io::u8* lo = static_cast<io::u8*>(first);
+    io::u8* hi = lo + 64 * 1024;
+    for (int i = 0; i < 100; ++i) {
+        io::u8* p = static_cast<io::u8*>(pool.allocate());
+        REQUIRE(p != nullptr);
+        REQUIRE(p > lo);
+        REQUIRE(p < hi);
+        REQUIRE((p - lo) % 64 == 0);
+    }
+}
+
+TEST_CASE("io::native::SlotPool carves a slab lazily", "[io][slot_alloc][slab]") {
+    using Pool = io::native::SlotPool<4096, 256 * 1024>;
+    static Pool pool;
+
+    io::native::FreeNode* head = nullptr;
+    REQUIRE(pool.allocate_batch(head, 4) == 4);
+
+    // only the handed-out slots plus one carve batch are linked; the rest of
+    // the slab (and its pages) stays untouched
+    io::usize parked = 0;
+    while (pool.free_list.pop()) ++parked;
+    REQUIRE(parked == Pool::CARVE_BATCH);
+
+    // the next refill continues right after them in the same slab
+    io::native::FreeNode* more = nullptr;
+    REQUIRE(pool.allocate_batch(more, 2) == 2);
+    REQUIRE(reinterpret_cast<io::u8*>(more) == reinterpret_cast<io::u8*>(head) + (4 + parked) * 4096);
+}
+
+TEST_CASE("io::native::SlotPool slots are aligned and reused after deallocate", "[io][slot_alloc]") {
+    io::native::SlotPool<32, 64 * 1024> pool;
+
+    void* a = pool.allocate();
+    REQUIRE(a != nullptr);
+    REQUIRE(reinterpret_cast<io::usize>(a) % io::native::DEFAULT_ALIGNMENT == 0);
+
+    pool.deallocate(a);
+    void* b = pool.allocate();
+    REQUIRE(b == a); // LIFO free list
+    pool.deallocate(b);
+}
+
+TEST_CASE("io::native::allocate_block round-trips every size class", "[io][slot_alloc]") {
+    const io::usize sizes[] = { 1, 8, 15, 16, 33, 100, 200, 240, 300, 5000, 65536, 70000, 1u << 20 };
+
+    for (io::usize sz : sizes) {
+        auto* p = static_cast<io::u8*>(io::native::allocate_block(sz));
+        REQUIRE(p != nullptr);
+        // nothing that fits in 8 bytes can need more than 8-byte alignment
+        const io::usize align = sz <= 8 ? 8 : io::native::DEFAULT_ALIGNMENT;
+        REQUIRE(reinterpret_cast<io::usize>(p) % align == 0);
+        for (io::usize i = 0; i < sz; ++i) p[i] = static_cast<io::u8>(i);
+        bool intact = true;
+        for (io::usize i = 0; i < sz; ++i) intact = intact && p[i] == static_cast<io::u8>(i);
+        REQUIRE(intact);
+        io::native::deallocate_block(p);
+    }
+}
+
+TEST_CASE("io::native::allocate_block serves small sizes header-free from the matching pool", "[io][slot_alloc][headerless]") {
+    // a 1-byte block lands in the 8-byte pool; the chunk map knows its class
+    void* one = io::native::allocate_block(1);
+    REQUIRE(one != nullptr);
+    REQUIRE(io::native::global::chunk_map.get(one) == 8);
+
+    // 16 requested bytes fit the 16-byte pool exactly (a header would push it to 32)
+    void* a = io::native::allocate_block(16);
+    void* b = io::native::allocate_block(16);
+    REQUIRE(io::native::global::chunk_map.get(a) == 16);
+    REQUIRE(io::native::global::chunk_map.get(b) == 16);
+
+    io::native::deallocate_block(one, 1); // sized: no lookup
+    io::native::deallocate_block(a);      // unsized: chunk map lookup
+    io::native::deallocate_block(b, 16);
+
+}
+
+TEST_CASE("io::native::allocate_block maps medium sizes to page-run classes", "[io][slot_alloc][medium]") {
+    REQUIRE(io::native::pool_index(256) == 5);
+    REQUIRE(io::native::pool_index(257) == 6);
+    REQUIRE(io::native::pool_block_size(io::native::pool_index(3000)) == 4096);
+    REQUIRE(io::native::pool_index(65536) == io::native::POOL_COUNT - 1);
+    REQUIRE(io::native::pool_index(65537) == io::native::POOL_COUNT);
+
+    void* p = io::native::allocate_block(3000);
+    REQUIRE(p != nullptr);
+    REQUIRE(io::native::global::chunk_map.get(p) == 4096);
+    REQUIRE(reinterpret_cast<io::usize>(p) % 4096 == 0); // slots of >= a page are page runs
+    io::native::deallocate_block(p, 3000);
+}
+
+TEST_CASE("io::native::deallocate_block rejects pointers it never handed out", "[io][slot_alloc][headerless]") {
+    static io::u64 foreign[4];
+#ifdef NDEBUG
+    // dropped, not pushed into pool8
+    io::native::deallocate_block(foreign);
+    void* ptrs[256];
+    bool clean = true;
+    for (auto& p : ptrs) { p = io::native::allocate_block(8); clean &= p != foreign; }
+    for (auto& p : ptrs) io::native::deallocate_block(p);
+    REQUIRE(clean);
+#elif defined(_WIN32)
+    WARN("Skipping on Windows: debug builds break into the debugger.");
+    SUCCEED();
+#else
+    // debug builds trap; run it in a child
+    pid_t pid = fork();
+    REQUIRE(pid != -1);
+    if (pid == 0) {
+        ::signal(SIGILL, SIG_DFL); // die quietly instead of via Catch's handler
+        ::signal(SIGTRAP, SIG_DFL);
+        io::native::deallocate_block(foreign);
+        _exit(0); // should never reach
+    }
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFSIGNALED(status));
+#endif
+}
+
+TEST_CASE("io::native large blocks are page-aligned own mappings", "[io][slot_alloc][large]") {
+    const io::usize size = 300 * 1024;
+    auto* p = static_cast<io::u8*>(io::native::allocate_block(size));
+    REQUIRE(p != nullptr);
+    REQUIRE(reinterpret_cast<io::usize>(p) % io::page_size() == 0);
+
+    const io::u32 tag = io::native::global::chunk_map.get(p);
+    REQUIRE((tag & io::native::ChunkMap::LARGE) != 0);
+    REQUIRE(((tag & ~io::native::ChunkMap::LARGE) << io::native::ChunkMap::CHUNK_SHIFT) >= size);
+    // every chunk of the block resolves to the same tag
+    REQUIRE(io::native::global::chunk_map.get(p + size - 1) == tag);
+
+    p[0] = 1; p[size - 1] = 2;
+    io::native::deallocate_block(p);
+    REQUIRE(io::native::global::chunk_map.get(p) == 0);
+}
+
+TEST_CASE("io::native large requests that cannot be rounded to a chunk fail", "[io][slot_alloc][large]") {
+    const io::usize huge = ~io::usize(0) - 1;
+    REQUIRE(io::native::allocate_block(huge) == nullptr);
+    REQUIRE(io::native::allocate_block(io::native::MAX_LARGE + 1) == nullptr);
+    REQUIRE(io::native::allocate_block_aligned(huge, 1u << 20) == nullptr);
+    REQUIRE(io::map_pages_aligned(huge, 1u << 20) == nullptr);
+
+    // a failed resize leaves the block where it was
+    auto* p = static_cast<io::u8*>(io::native::allocate_block(300 * 1024));
+    REQUIRE(p != nullptr);
+    p[0] = 42;
+    REQUIRE(io::native::reallocate_block(p, 300 * 1024, huge) == nullptr);
+    REQUIRE(io::native::reallocate_block(p, 300 * 1024, huge, 1u << 20) == nullptr);
+    REQUIRE(p[0] == 42);
+    io::native::deallocate_block(p, 300 * 1024);
+}
+
+TEST_CASE("io::native::allocate_block_aligned aligns small, medium and large blocks", "[io][slot_alloc][aligned]") {
+    const io::usize aligns[] = { 16, 32, 64, 4096, io::native::ChunkMap::CHUNK_BYTES, 1u << 20 };
+    const io::usize sizes[] = { 1, 24, 100, 5000, 300 * 1024 };
+    for (io::usize al : aligns) {
+        for (io::usize sz : sizes) {
+            auto* p = static_cast<io::u8*>(io::native::allocate_block_aligned(sz, al));
+            REQUIRE(p != nullptr);
+            REQUIRE(reinterpret_cast<io::usize>(p) % al == 0);
+            p[0] = 1; p[sz - 1] = 2;
+            // sized and unsized frees both find the block
+            if (sz & 1) io::native::deallocate_block(p);
+            else        io::native::deallocate_block_aligned(p, sz, al);
+        }
+    }
+
+    // growth keeps the alignment
+    auto* p = static_cast<io::u8*>(io::native::allocate_block_aligned(64, 1u << 20));
+    p[0] = 42;
+    p = static_cast<io::u8*>(io::native::reallocate_block(p, 64, 4u << 20, 1u << 20));
+    REQUIRE(p != nullptr);
+    REQUIRE(reinterpret_cast<io::usize>(p) % (1u << 20) == 0);
+    REQUIRE(p[0] == 42);
+    io::native::deallocate_block_aligned(p, 4u << 20, 1u << 20);
+}
+
+TEST_CASE("io::native::reallocate_block keeps contents across classes and remaps", "[io][slot_alloc][large]") {
+    // same class: nothing moves
+    auto* p = static_cast<io::u8*>(io::native::allocate_block(40));
+    REQUIRE(io::native::reallocate_block(p, 40, 60) == p);
+
+    // small -> large -> larger -> small, contents preserved each step
+    for (io::u8 i = 0; i < 64; ++i) p[i] = i;
+    p = static_cast<io::u8*>(io::native::reallocate_block(p, 64, 200 * 1024));
+    REQUIRE(p != nullptr);
+    for (io::usize i = 200 * 1024 - 4096; i < 200 * 1024; ++i) p[i] = static_cast<io::u8>(i);
+
+    const io::usize big = 3u << 20;
+    p = static_cast<io::u8*>(io::native::reallocate_block(p, 200 * 1024, big));
+    REQUIRE(p != nullptr);
+    REQUIRE(reinterpret_cast<io::usize>(p) % io::native::ChunkMap::CHUNK_BYTES == 0);
+    bool same = true;
+    for (io::u8 i = 0; i < 64; ++i) same &= p[i] == i;
+    for (io::usize i = 200 * 1024 - 4096; i < 200 * 1024; ++i) same &= p[i] == static_cast<io::u8>(i);
+    REQUIRE(same);
+
+    // tags follow the block wherever it landed
+    const io::u32 tag = io::native::global::chunk_map.get(p);
+    REQUIRE((tag & io::native::ChunkMap::LARGE) != 0);
+    REQUIRE(((tag & ~io::native::ChunkMap::LARGE) << io::native::ChunkMap::CHUNK_SHIFT) >= big);
+    REQUIRE(io::native::global::chunk_map.get(p + big - 1) == tag);
+    p[big - 1] = 7;
+
+    p = static_cast<io::u8*>(io::native::reallocate_block(p, big, 32));
+    REQUIRE(p != nullptr);
+    REQUIRE(p[63 - 32] == 63 - 32);
+    REQUIRE(io::native::global::chunk_map.get(p) == 32);
+    io::native::deallocate_block(p, 32);
+}
+
+TEST_CASE("io::native::SlotPool allocate_batch/deallocate_batch exchange linked chains", "[io][slot_alloc][magazine]") {
+    io::native::SlotPool<16, 64 * 1024> pool;
+
+    io::native::FreeNode* head = nullptr;
+    io::usize n = pool.allocate_batch(head, 10);
+    REQUIRE(n == 10);
+
+    io::native::FreeNode* last = head;
+    io::usize walked = 1;
+    while (last->next) { last = last->next; ++walked; }
+    REQUIRE(walked == 10);
+
+    pool.deallocate_batch(head, last);
+
+    // the whole chain is back: next batch hands out the same slots
+    io::native::FreeNode* again = nullptr;
+    REQUIRE(pool.allocate_batch(again, 10) == 10);
+    bool found = false;
+    for (io::native::FreeNode* p = again; p; p = p->next) if (p == head) found = true;
+    REQUIRE(found);
+}
+
+TEST_CASE("io::native thread cache recycles blocks and flushes back to the pools", "[io][slot_alloc][magazine]") {
+    void* ptrs[200];
+    for (auto& p : ptrs) { p = io::native::allocate_block(24); REQUIRE(p != nullptr); }
+    for (auto& p : ptrs) io::native::deallocate_block(p);
+
+    // most recently freed block comes straight back out of the magazine
+    void* again = io::native::allocate_block(24);
+    REQUIRE(again == ptrs[199]);
+    io::native::deallocate_block(again);
+
+    io::native::flush_thread_cache();
+    void* after = io::native::allocate_block(24);
+    REQUIRE(after != nullptr);
+    io::native::deallocate_block(after);
+}
+
+TEST_CASE("io::native thread cache is flushed when its thread exits", "[io][slot_alloc][magazine]") {
+    // fewer than a magazine holds, so without the exit flush they stay parked
+    void* ptrs[4];
+    std::thread([&ptrs] {
+        for (auto& p : ptrs) p = io::native::allocate_block(16384);
+        for (auto& p : ptrs) io::native::deallocate_block(p);
+    }).join();
+
+    io::native::FreeNode* chain = io::native::global::pool16384.free_list.take_all();
+    int found = 0;
+    io::native::FreeNode* last = nullptr;
+    for (io::native::FreeNode* n = chain; n; n = n->next) {
+        for (void* p : ptrs) found += n == p;
+        last = n;
+    }
+    if (chain) io::native::global::pool16384.free_list.push(chain, last);
+    REQUIRE(found == 4);
+}
+
+// ============================================================
+//                           trim
+// ============================================================
+
+TEST_CASE("io::native::SlotPool trim releases only fully free slabs", "[io][slot_alloc][trim]") {
+    using Pool = io::native::SlotPool<1024, 64 * 1024>;
+    static Pool pool; // registry + lock, like the globals
+    const io::usize per_slab = Pool::SLOTS;
+
+    void* ptrs[64 * 4];
+    const io::usize n = per_slab * 4;
+    for (io::usize i = 0; i < n; ++i) { ptrs[i] = pool.allocate(); REQUIRE(ptrs[i] != nullptr); }
+
+    // keep one slot alive: its slab must survive the trim
+    void* pinned = ptrs[0];
+    for (io::usize i = 1; i < n; ++i) pool.deallocate(ptrs[i]);
+
+    REQUIRE(pool.trim() == 3 * 64 * 1024);
+    REQUIRE(pool.trim() == 0); // nothing left to release
+
+    // discarded slabs are carved again (same addresses), contents usable
+    void* again[64 * 4];
+    bool reused = true;
+    for (io::usize i = 1; i < n; ++i) {
+        auto* p = static_cast<io::u8*>(pool.allocate());
+        REQUIRE(p != nullptr);
+        p[0] = 1; p[1023] = 2;
+        bool known = false;
+        for (io::usize j = 1; j < n && !known; ++j) known = ptrs[j] == p;
+        reused = reused && known;
+        again[i] = p;
+    }
+    REQUIRE(reused);
+
+    pool.deallocate(pinned);
+    for (io::usize i = 1; i < n; ++i) pool.deallocate(again[i]);
+    REQUIRE(pool.trim() == 4 * 64 * 1024);
+}
+
+TEST_CASE("io::native::trim returns freed pool memory to the OS", "[io][slot_alloc][trim]") {
+    // well past the magazine, so whole slabs end up free
+    static void* ptrs[4096];
+    for (auto& p : ptrs) { p = io::native::allocate_block(200); REQUIRE(p != nullptr); }
+    for (auto& p : ptrs) io::native::deallocate_block(p);
+
+    REQUIRE(io::native::trim() >= 8 * IO_SLOT_SLAB_BYTES_256);
+
+    // still allocatable afterwards
+    void* p = io::native::allocate_block(200);
+    REQUIRE(p != nullptr);
+    io::native::deallocate_block(p);
+}
+
+TEST_CASE("io::native trim policy trims from the deallocation slow path", "[io][slot_alloc][trim]") {
+    static void* ptrs[2048];
+    for (auto& p : ptrs) p = io::native::allocate_block(100);
+
+    io::native::set_trim_policy(io::native::TrimPolicy{ 0.001 });
+    io::sleep_ms(5);
+
+    // magazine overflow (or, without thread caches, a chunk's first slot) -> trim_tick -> trim()
+    for (auto& p : ptrs) io::native::deallocate_block(p);
+    io::sleep_ms(5);
+
+    // overflow another class's magazine -> slow path -> trim_tick -> trim()
+    void* other[128];
+    for (auto& p : other) p = io::native::allocate_block(40);
+    for (auto& p : other) io::native::deallocate_block(p);
+
+    io::native::set_trim_policy(io::native::TrimPolicy{});
+    // whatever the policy left behind, an explicit trim has nothing big to do
+    REQUIRE(io::native::trim() < 4 * IO_SLOT_SLAB_BYTES_128);
+}
+
+// ============================================================
+//                        statistics
+// ============================================================
+
+TEST_CASE("io::native::alloc_stats counts per size class", "[io][slot_alloc][stats]") {
+    using io::native::alloc_stats;
+    const io::usize idx = io::native::pool_index(48); // 64-byte class
+    const io::usize large = io::native::POOL_COUNT;
+
+    const io::native::AllocStats before = alloc_stats();
+    REQUIRE(before.classes[idx].block_size == 64);
+
+    void* ptrs[10];
+    for (auto& p : ptrs) p = io::native::allocate_block(48);
+    void* big = io::native::allocate_block(1u << 20);
+    const io::native::AllocStats mid = alloc_stats();
+    for (auto& p : ptrs) io::native::deallocate_block(p, 48);
+    io::native::deallocate_block(big);
+    const io::native::AllocStats after = alloc_stats();
+
+    if (!io::native::AllocStats::enabled) {
+        REQUIRE(after.total.allocs == 0);
+        REQUIRE(after.classes[idx].live_bytes == 0);
+        return;
+    }
+    REQUIRE(mid.classes[idx].allocs - before.classes[idx].allocs == 10);
+    REQUIRE(mid.classes[idx].live_bytes - before.classes[idx].live_bytes == 640);
+    REQUIRE(mid.classes[idx].peak_bytes >= mid.classes[idx].live_bytes);
+    REQUIRE(mid.classes[large].live_bytes - before.classes[large].live_bytes == (1u << 20));
+    REQUIRE(mid.total.peak_bytes >= mid.total.live_bytes);
+
+    REQUIRE(after.classes[idx].frees - before.classes[idx].frees == 10);
+    REQUIRE(after.classes[idx].live_bytes == before.classes[idx].live_bytes);
+    REQUIRE(after.classes[large].live_bytes == before.classes[large].live_bytes);
+    REQUIRE(after.classes[large].syscalls - before.classes[large].syscalls == 2); // map + unmap
+}
+
+// ============================================================
+//                 multi-threaded stress (ABA)
+// ============================================================
+
+// Every thread repeatedly grabs a handful of slots straight from one shared
+// pool (no thread cache), stamps them with its id, yields and verifies the
+// stamps before freeing. A lost ABA race hands the same slot to two threads
+// (or corrupts the list), which shows up as a foreign stamp.
+static int slot_pool_stress(io::native::ISlotPool& pool, int threads, int rounds) {
+    io::atomic<int> corrupted{ 0 };
+    std::thread workers[16];
+
+    for (int t = 0; t < threads; ++t) {
+        workers[t] = std::thread([&pool, &corrupted, t, rounds] {
+            const io::usize stamp = static_cast<io::usize>(t) + 1;
+            for (int r = 0; r < rounds; ++r) {
+                io::usize* held[8];
+                const int n = 1 + (r % 8);
+                for (int i = 0; i < n; ++i) {
+                    held[i] = static_cast<io::usize*>(pool.allocate());
+                    held[i][1] = stamp;
+                }
+                if ((r & 63) == 0) std::this_thread::yield();
+                for (int i = 0; i < n; ++i) {
+                    if (held[i][1] != stamp) (void)corrupted.fetch_add(1);
+                    pool.deallocate(held[i]);
+                }
+            }
+        });
+    }
+    for (int t = 0; t < threads; ++t) workers[t].join();
+    return corrupted.load();
+}
+
+TEST_CASE("io::native::SlotPool survives concurrent allocate/deallocate without ABA corruption", "[io][slot_alloc][stress]") {
+    io::native::SlotPool<16, 64 * 1024> pool;
+    REQUIRE(slot_pool_stress(pool, 8, 200000) == 0);
+}
+
+TEST_CASE("io::native::SlotPool contended throughput", "[.][io][slot_alloc][bench]") {
+    io::native::SlotPool<32, 64 * 1024> pool;
+    const int threads = 8, rounds = 1000000;
+
+    const double t0 = io::monotonic_seconds();
+    REQUIRE(slot_pool_stress(pool, threads, rounds) == 0);
+    const double dt = io::monotonic_seconds() - t0;
+
+    // every round allocates and frees 4.5 slots on average
+    WARN("SlotPool<32>: " << (threads * rounds * 9.0) / dt / 1e6 << " M ops/s over " << threads << " threads");
+}
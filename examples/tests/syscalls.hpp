@@ -58,6 +58,56 @@ TEST_CASE("io::free(nullptr) is safe", "[io][syscalls][free]") {
     SUCCEED();
 }
 
+TEST_CASE("io::map_pages with page flags returns usable memory or falls back", "[io][syscalls][pages]") {
+    using io::PageFlags;
+    const io::usize huge = io::huge_page_size();
+    const io::usize big = huge ? huge * 2 : 4u * 1024u * 1024u;
+
+    const PageFlags variants[] = {
+        PageFlags::None,
+        PageFlags::Prefault,
+        PageFlags::HugeHint,
+        PageFlags::HugePages,                       // usually no reserved huge pages -> fallback
+        PageFlags::HugePages | PageFlags::Prefault,
+    };
+    for (PageFlags f : variants) {
+        void* p = io::map_pages(big, f);
+        REQUIRE(p != nullptr);
+        REQUIRE(reinterpret_cast<io::usize>(p) % io::page_size() == 0);
+        REQUIRE(can_write_bytes(p, 4096));
+        static_cast<unsigned char*>(p)[big - 1] = 7;
+        io::unmap_pages(p, big);
+    }
+
+    // sizes that aren't whole huge pages quietly use normal pages
+    void* odd = io::map_pages(12345, PageFlags::HugePages | PageFlags::Prefault);
+    REQUIRE(odd != nullptr);
+    REQUIRE(can_write_bytes(odd, 12345));
+    io::unmap_pages(odd, 12345);
+}
+
+TEST_CASE("io::alloc with page flags round-trips through io::free", "[io][syscalls][alloc]") {
+    const io::usize sizes[] = { 1, 4096, 3u * 1024u * 1024u };
+    for (io::usize sz : sizes) {
+        void* p = io::alloc(sz, io::PageFlags::HugePages | io::PageFlags::Prefault);
+        REQUIRE(p != nullptr);
+        REQUIRE(can_write_bytes(p, sz));
+        io::free(p);
+    }
+}
+
+TEST_CASE("io::alloc_aligned honors SIMD, cache-line and page alignment", "[io][syscalls][alloc]") {
+    const io::usize aligns[] = { 1, 32, 64, 4096, 1u << 20 };
+    for (io::usize al : aligns) {
+        void* p = io::alloc_aligned(1000, al);
+        REQUIRE(p != nullptr);
+        REQUIRE(reinterpret_cast<io::usize>(p) % al == 0);
+        REQUIRE(can_write_bytes(p, 1000));
+        io::free_aligned(p);
+    }
+    io::free_aligned(nullptr);
+}
+
 TEST_CASE("io::monotonic_seconds is non-decreasing", "[io][syscalls][time]") {
     double t1 = io::monotonic_seconds();
     double t2 = io::monotonic_seconds();
@@ -90,6 +140,14 @@ TEST_CASE("io::sleep_ms sleeps at least roughly the requested time", "[io][sysca
     REQUIRE(dt_ms < 50.0);
 }
 
+TEST_CASE("io::futex_wait returns at once when the word already changed", "[io][syscalls][futex]") {
+    io::u32 word = 1;
+    io::futex_wait(&word, 0); // would block forever if the value check were skipped
+    io::futex_wake_one(&word); // no waiters: a no-op
+    io::futex_wake_all(&word);
+    REQUIRE(word == 1);
+}
+
 TEST_CASE("io::exit_process terminates the process with given code (run in child)", "[io][syscalls][exit]") {
 #ifdef _WIN32
     WARN("Skipping on Windows (needs custom main/argv or helper exe).");
@@ -60,6 +60,23 @@ TEST_CASE("io::remove_reference_t removes references", "[types][io][traits]") {
     STATIC_REQUIRE(io::is_same_v<io::remove_reference_t<int&&>, int>);
 }
 
+TEST_CASE("io triviality traits match the compiler's view", "[types][io][traits]") {
+    struct Pod { int a; float b; };
+    struct Owner { int* p; ~Owner() {} };
+    struct Counted { int v; Counted() : v(1) {} };
+
+    STATIC_REQUIRE(io::is_trivially_copyable_v<Pod>);
+    STATIC_REQUIRE(io::is_trivially_relocatable_v<Pod>);
+    STATIC_REQUIRE(io::is_trivially_destructible_v<Pod>);
+    STATIC_REQUIRE(io::is_trivially_default_constructible_v<Pod>);
+
+    STATIC_REQUIRE(!io::is_trivially_copyable_v<Owner>);
+    STATIC_REQUIRE(!io::is_trivially_destructible_v<Owner>);
+
+    STATIC_REQUIRE(io::is_trivially_copyable_v<Counted>);
+    STATIC_REQUIRE(!io::is_trivially_default_constructible_v<Counted>);
+}
+
 TEST_CASE("io::move casts to rvalue ref (type-level check)", "[types][io][move]") {
     int x = 7;
     // Сheck the type of the result: remove_reference_t<T>&&
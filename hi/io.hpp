@@ -7,7 +7,12 @@
 #include "native/syscalls.hpp"
 #include "native/atomic.hpp"
 #include "native/containers.hpp"
+#include "native/stable_vector.hpp"
+#include "native/hash.hpp"
+#include "native/hash_map.hpp"
+#include "native/queue.hpp"
 #include "native/ptr.hpp"
+#include "native/arena.hpp"
 
 #pragma region micro shit
 // I ******* hate Microsoft products
@@ -0,0 +1,87 @@
+#pragma once
+#include "types.hpp"
+#include "arena.hpp"
+#include "mem.hpp"
+
+namespace io {
+
+    // ------------------------- Allocators ------------------------------
+    // Containers take their memory through an `Alloc` template parameter:
+    //
+    //     void* allocate(usize bytes, usize align) noexcept;   // nullptr on failure
+    //     void  deallocate(void* ptr, usize bytes, usize align) noexcept; // as allocated
+    //
+    // Optionally, for trivially relocatable contents:
+    //
+    //     void* reallocate(void* ptr, usize old_bytes, usize new_bytes, usize align) noexcept;
+    //
+    // keeps the first min(old, new) bytes and returns nullptr (ptr intact) on failure.
+    //
+    // Allocators are copied into the container and travel with it on move.
+    // Containers keep them as an empty base, so a stateless allocator adds no
+    // bytes and its calls inline away.
+
+    // Global operator new/delete - the default, same behavior as before.
+    // Sized delete lets the slot allocator skip the size-class lookup;
+    // over-aligned types go through the align_val_t overloads.
+    struct heap_allocator {
+        IO_NODISCARD void* allocate(usize bytes, usize align) noexcept {
+#ifdef __cpp_aligned_new
+            if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                return ::operator new[](bytes, static_cast<std::align_val_t>(align), std::nothrow);
+#else
+            (void)align;
+#endif
+            return ::operator new[](bytes, std::nothrow);
+        }
+        void deallocate(void* ptr, usize bytes, usize align) noexcept {
+#ifdef __cpp_aligned_new
+            if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ::operator delete[](ptr, bytes, static_cast<std::align_val_t>(align));
+                return;
+            }
+#else
+            (void)align;
+#endif
+            ::operator delete[](ptr, bytes);
+        }
+
+        // Freestanding builds own operator new, so large blocks are remapped
+        // (mremap) rather than copied; otherwise allocate + copy + free.
+        IO_NODISCARD void* reallocate(void* ptr, usize old_bytes, usize new_bytes, usize align) noexcept {
+#ifdef IO_NOSTD
+            return native::reallocate_block(ptr, old_bytes, new_bytes, align);
+#else
+            void* p = allocate(new_bytes, align);
+            if (!p) return nullptr;
+            if (ptr) {
+                io::mem::copy(p, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+                deallocate(ptr, old_bytes, align);
+            }
+            return p;
+#endif
+        }
+    }; // struct heap_allocator
+
+    // Borrows an io::Arena: frees are no-ops, memory goes away with the arena's
+    // next rewind/reset. The arena must outlive the container.
+    struct arena_allocator {
+        Arena* arena{ nullptr };
+
+        IO_CONSTEXPR arena_allocator() noexcept = default;
+        IO_CONSTEXPR arena_allocator(Arena& a) noexcept : arena{ &a } {}
+
+        IO_NODISCARD void* allocate(usize bytes, usize align) noexcept {
+            return arena ? arena->allocate(bytes, align) : nullptr;
+        }
+        void deallocate(void*, usize, usize) noexcept {}
+    }; // struct arena_allocator
+
+    // Does `A` provide `reallocate`?
+    template<typename A, typename = void>
+    struct has_reallocate : false_t {};
+
+    template<typename A>
+    struct has_reallocate<A, void_t<decltype(io::declval<A&>().reallocate(
+        static_cast<void*>(nullptr), usize(0), usize(0), usize(0)))>> : true_t {};
+} // namespace io
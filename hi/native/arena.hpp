@@ -0,0 +1,211 @@
+#pragma once
+#include "types.hpp"
+#include "syscalls.hpp"
+#include "slot_alloc.hpp" // DEFAULT_ALIGNMENT
+
+// -------------------- Arena block size --------------------------------------
+// Arenas map memory in blocks of at least this many bytes (rounded up to
+// whole pages); bigger requests get a block of their own.
+#ifndef IO_ARENA_BLOCK_BYTES
+#   define IO_ARENA_BLOCK_BYTES (64u * 1024u)
+#endif
+
+namespace io {
+
+    // ------------------------- Arena -----------------------------------
+    // Bump allocator over a chain of page blocks. Allocation is a pointer
+    // bump; nothing is freed individually. `mark()`/`rewind()` drop everything
+    // allocated after a point, `reset()` drops everything. Blocks are kept
+    // for reuse until `release()` or destruction, so a steady-state frame or
+    // request loop stops touching the OS after warm-up.
+    //
+    // Destructors of objects placed in an arena are never run: keep it to
+    // trivially destructible data, or destroy objects yourself.
+    // Not thread-safe; use one arena per thread.
+    //
+    // `flags` applies to every block mapping; with PageFlags::HugePages the
+    // blocks are rounded up to whole huge pages.
+    class Arena {
+        struct Block {
+            Block* next;
+            usize  size; // mapped bytes, header included
+        };
+
+    public:
+        struct Marker {
+            Block* block;
+            u8*    top;
+        };
+
+        explicit Arena(usize block_bytes = IO_ARENA_BLOCK_BYTES, PageFlags flags = PageFlags::None) noexcept
+            : _block_bytes{ block_bytes }, _flags{ flags } {}
+        ~Arena() noexcept { release(); }
+
+        Arena(Arena&& o) noexcept
+            : _head{ o._head }, _cur{ o._cur }, _top{ o._top }, _end{ o._end },
+              _block_bytes{ o._block_bytes }, _capacity{ o._capacity }, _flags{ o._flags } {
+            o._head = o._cur = nullptr;
+            o._top = o._end = nullptr;
+            o._capacity = 0;
+        }
+        Arena& operator=(Arena&& o) noexcept {
+            if (this == &o) return *this;
+            this->~Arena();
+            new (this) Arena(static_cast<Arena&&>(o));
+            return *this;
+        }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // `align` is a power of two. Returns nullptr only when the OS refuses pages.
+        IO_NODISCARD void* allocate(usize bytes, usize align = native::DEFAULT_ALIGNMENT) noexcept {
+            const usize at = (reinterpret_cast<usize>(_top) + align - 1) & ~(align - 1);
+            if (_cur && at + bytes <= reinterpret_cast<usize>(_end)) {
+                _top = reinterpret_cast<u8*>(at + bytes);
+                return reinterpret_cast<void*>(at);
+            }
+            return allocate_slow(bytes, align);
+        }
+
+        template <typename T>
+        IO_NODISCARD T* allocate_array(usize count) noexcept {
+            return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        template <typename T, typename... Args>
+        IO_NODISCARD T* make(Args&&... args) noexcept {
+            void* mem = allocate(sizeof(T), alignof(T));
+            return mem ? new (mem) T(io::forward<Args>(args)...) : nullptr;
+        }
+
+        IO_NODISCARD Marker mark() const noexcept { return Marker{ _cur, _top }; }
+
+        // Drops everything allocated since `m` was taken (blocks stay mapped).
+        void rewind(Marker m) noexcept {
+            if (!m.block) { reset(); return; }
+            _cur = m.block;
+            _top = m.top;
+            _end = reinterpret_cast<u8*>(_cur) + _cur->size;
+        }
+
+        // Drops every allocation and starts over from the first block.
+        void reset() noexcept {
+            _cur = _head;
+            if (!_cur) return;
+            _top = data(_cur);
+            _end = reinterpret_cast<u8*>(_cur) + _cur->size;
+        }
+
+        // Drops every allocation and returns all blocks to the OS.
+        void release() noexcept {
+            Block* b = _head;
+            while (b) {
+                Block* next = b->next;
+                io::unmap_pages(b, b->size);
+                b = next;
+            }
+            _head = _cur = nullptr;
+            _top = _end = nullptr;
+            _capacity = 0;
+        }
+
+        // Bytes mapped by this arena, block headers included.
+        IO_NODISCARD usize capacity() const noexcept { return _capacity; }
+
+    private:
+        Block* _head{ nullptr };
+        Block* _cur{ nullptr };   // block being bumped
+        u8*    _top{ nullptr };   // next free byte in _cur
+        u8*    _end{ nullptr };   // one past _cur
+        usize  _block_bytes;
+        usize  _capacity{ 0 };
+        PageFlags _flags;
+
+        static u8* data(Block* b) noexcept {
+            return reinterpret_cast<u8*>(b) + sizeof(Block);
+        }
+
+        static bool fits(Block* b, usize bytes, usize align) noexcept {
+            const usize at = (reinterpret_cast<usize>(data(b)) + align - 1) & ~(align - 1);
+            return at + bytes <= reinterpret_cast<usize>(b) + b->size;
+        }
+
+        void enter(Block* b) noexcept {
+            _cur = b;
+            _top = data(b);
+            _end = reinterpret_cast<u8*>(b) + b->size;
+        }
+
+        void* allocate_slow(usize bytes, usize align) noexcept {
+            // blocks past the current one are left over from rewind()/reset()
+            Block* next = _cur ? _cur->next : _head;
+            if (next && fits(next, bytes, align)) {
+                enter(next);
+                return allocate(bytes, align);
+            }
+
+            // fresh block, linked in front of any leftovers so markers stay ordered
+            const usize huge = has(_flags, PageFlags::HugePages) ? io::huge_page_size() : 0;
+            const usize page = huge ? huge : io::page_size();
+            usize size = sizeof(Block) + bytes + align;
+            if (size < _block_bytes) size = _block_bytes;
+            size = (size + page - 1) & ~(page - 1);
+
+            Block* b = static_cast<Block*>(io::map_pages(size, _flags));
+            if (!b) return nullptr;
+            b->size = size;
+            b->next = next;
+            if (_cur) _cur->next = b;
+            else      _head = b;
+            _capacity += size;
+
+            enter(b);
+            return allocate(bytes, align);
+        }
+    }; // class Arena
+
+    // ------------------------- ArenaScope ------------------------------
+    // Rewinds the arena to where it was when the scope was entered.
+    class ArenaScope {
+    public:
+        explicit ArenaScope(Arena& a) noexcept : _arena{ a }, _mark{ a.mark() } {}
+        ~ArenaScope() noexcept { _arena.rewind(_mark); }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+    private:
+        Arena& _arena;
+        Arena::Marker _mark;
+    }; // class ArenaScope
+
+    // ------------------------- FrameArena ------------------------------
+    // Round-robin set of arenas for per-frame scratch memory. `next()` moves
+    // to the following arena and resets it, so whatever was allocated during
+    // the last `Frames - 1` frames stays valid (e.g. data still read by the
+    // GPU or by the next frame's diff).
+    template <usize Frames = 2>
+    class FrameArena {
+        static_assert(Frames > 0, "FrameArena needs at least one arena");
+
+    public:
+        FrameArena() noexcept = default;
+
+        IO_NODISCARD Arena& current() noexcept { return _arenas[_index]; }
+        IO_NODISCARD Arena& previous() noexcept { return _arenas[(_index + Frames - 1) % Frames]; }
+
+        void next() noexcept {
+            _index = (_index + 1) % Frames;
+            _arenas[_index].reset();
+        }
+
+        void release() noexcept {
+            for (usize i = 0; i < Frames; ++i) _arenas[i].release();
+        }
+
+    private:
+        Arena _arenas[Frames];
+        usize _index{ 0 };
+    }; // class FrameArena
+} // namespace io
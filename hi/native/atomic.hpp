@@ -51,6 +51,12 @@
 #  define IO_HAS___SYNC_BUILTINS 0
 #endif
 
+// Destructive interference size: data written by different threads is kept
+// this many bytes apart (128 suits some ARM64 cores).
+#ifndef IO_CACHE_LINE
+#  define IO_CACHE_LINE 64
+#endif
+
 namespace io {
 
     // Simple memory_order enum for API parity. If std::atomic is present we'll use std::memory_order.
@@ -253,4 +259,20 @@ namespace io {
 #endif // IO_HAS_STD_ATOMIC
     }; // class atomic
 
+    // Standalone fence; seq_cst orders an earlier store before a later load
+    // (the store-buffer case release/acquire cannot cover).
+    static inline void atomic_thread_fence(memory_order mo) noexcept {
+#if IO_HAS_STD_ATOMIC
+        std::atomic_thread_fence(mo);
+#elif IO_HAS___ATOMIC_BUILTINS
+        (void)mo;
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#elif IO_HAS___SYNC_BUILTINS
+        (void)mo;
+        __sync_synchronize();
+#else
+        (void)mo;
+#endif
+    }
+
 } // namespace io
@@ -1,28 +1,83 @@
 #pragma once
 #include "types.hpp"
 #include "ptr.hpp"   // unique_array
+#include "allocator.hpp"
+
+// Target bytes per io::deque block (rounded down to a power-of-two element
+// count, at least 16 elements).
+#ifndef IO_DEQUE_BLOCK_BYTES
+#   define IO_DEQUE_BLOCK_BYTES 4096u
+#endif
 
 namespace io {
+    namespace native {
+        // ---------------- Element range helpers ----------------
+        // Bulk byte operations where the type allows it, element loops otherwise.
+
+        // Moves `n` elements into uninitialized `dst` and ends their lifetime at `src`.
+        template<typename T>
+        inline void relocate(T* dst, T* src, usize n) noexcept {
+            if (is_trivially_relocatable_v<T>) {
+                if (n) IO_MEMCPY(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+                return;
+            }
+            for (usize i = 0; i < n; ++i) {
+                new (dst + i) T(io::move(src[i]));
+                src[i].~T();
+            }
+        }
+
+        template<typename T>
+        inline void destroy(T* p, usize n) noexcept {
+            if (is_trivially_destructible_v<T> || !p) return;
+            for (usize i = n; i > 0; --i) // reverse order is usually safer
+                p[i - 1].~T();
+        }
+
+        // Copy-constructs `n` elements into uninitialized `dst`.
+        template<typename T>
+        inline void copy_init(T* dst, const T* src, usize n) noexcept {
+            if (is_trivially_copyable_v<T>) {
+                if (n) IO_MEMCPY(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+                return;
+            }
+            for (usize i = 0; i < n; ++i) new (dst + i) T(src[i]);
+        }
+
+        template<typename T>
+        inline void value_init(T* p, usize n) noexcept {
+            if (is_trivially_default_constructible_v<T> && is_trivially_copyable_v<T>) {
+                if (n) IO_MEMSET(static_cast<void*>(p), 0, n * sizeof(T));
+                return;
+            }
+            for (usize i = 0; i < n; ++i) new (p + i) T{};
+        }
+
+        // floor(log2(x)) for x > 0; sizes power-of-two rings and blocks.
+        IO_NODISCARD IO_CONSTEXPR usize floor_log2(usize x) noexcept {
+            return x <= 1 ? 0 : 1 + floor_log2(x >> 1);
+        }
+    } // namespace native
 
-    template<typename T>
-    struct vector {
+    // The allocator is an empty base, so the default one costs no storage.
+    template<typename T, typename Alloc = heap_allocator>
+    struct vector : private Alloc {
         using value_type = T;
+        using allocator_type = Alloc;
 
         IO_CONSTEXPR vector() noexcept = default;
+        explicit vector(const Alloc& a) noexcept : Alloc(a) {}
 
         ~vector() noexcept {
-            destroy_range(this->_ptr, this->_len);
-            _raw.reset(nullptr); // delete[] bytes
-            _ptr = nullptr;
+            native::destroy(_ptr, _len);
+            release(); // free bytes
             _len = 0;
-            _cap = 0;
         }
 
         vector(const vector&) = delete;
         vector& operator=(const vector&) = delete;
 
-        vector(vector&& o) noexcept {
-            _raw = static_cast<unique_bytes&&>(o._raw); // move
+        vector(vector&& o) noexcept : Alloc(static_cast<Alloc&&>(o)) {
             _ptr = o._ptr;  o._ptr = nullptr;
             _len = o._len;  o._len = 0;
             _cap = o._cap;  o._cap = 0;
@@ -35,6 +90,8 @@ namespace io {
             return *this;
         }
 
+        IO_NODISCARD const Alloc& get_allocator() const noexcept { return *this; }
+
         // -------- view conversion --------
         IO_NODISCARD view<T> as_view() noexcept { return view<T>(_ptr, _len); }
         IO_NODISCARD view<const T> as_view() const noexcept { return view<const T>(_ptr, _len); }
@@ -70,20 +127,8 @@ namespace io {
             usize target = _cap ? (_cap * 2) : 8;
             if (target < new_cap) target = new_cap;
 
-            // Allocate raw bytes for T[target]
-            u8* new_raw = static_cast<u8*>(::operator new[](target * sizeof(T)));
-            if (!new_raw) return false; // only meaningful if new[] returns nullptr
-
-            T* new_ptr = reinterpret_cast<T*>(new_raw);
-
-            // move-construct existing elements into new storage
-            // if you compile with exceptions off, this is fine.
-            for (usize i = 0; i < _len; ++i) {
-                new (new_ptr + i) T(io::move(_ptr[i]));
-                _ptr[i].~T();
-            }
-            // Release old bytes and adopt new bytes
-            _raw.reset(new_raw);
+            T* new_ptr = grow(target, constant<bool, is_trivially_relocatable_v<T> && has_reallocate<Alloc>::value>{});
+            if (!new_ptr) return false;
             _ptr = new_ptr;
             _cap = target;
             return true;
@@ -95,16 +140,21 @@ namespace io {
                 if (!reserve(n)) return false;
             }
 
-            if (n > _len) {
-                for (usize i = _len; i < n; ++i)
-                    new (_ptr + i) T{}; // construct new elements
-            }
-            else if (n < _len) {
-                // destroy extra in reverse order (more std::vector-like)
-                for (io::usize i = _len; i > n; --i) {
-                    _ptr[i - 1].~T();
-                }
+            if (n > _len) native::value_init(_ptr + _len, n - _len);
+            else native::destroy(_ptr + n, _len - n);
+            _len = n;
+            return true;
+        }
+
+        // resize to n, default-initializing new elems: trivial types are left
+        // uninitialized for the caller to overwrite (e.g. a read target)
+        IO_NODISCARD bool resize_for_overwrite(usize n) noexcept {
+            if (n > _cap) {
+                if (!reserve(n)) return false;
             }
+
+            for (usize i = _len; i < n; ++i) new (_ptr + i) T;
+            if (n < _len) native::destroy(_ptr + n, _len - n);
             _len = n;
             return true;
         }
@@ -131,7 +181,7 @@ namespace io {
         }
 
         void clear() noexcept {
-            destroy_range(_ptr, _len);
+            native::destroy(_ptr, _len);
             _len = 0;
         }
 
@@ -141,122 +191,393 @@ namespace io {
         }
 
     private:
-        unique_bytes _raw{}; // owner of raw bytes
-        T* _ptr{ nullptr };
+        T* _ptr{ nullptr }; // owns _cap * sizeof(T) bytes from Alloc
         usize _len{ 0 };
         usize _cap{ 0 };
 
-        static void destroy_range(T* p, usize n) noexcept {
-            if (!p) return;
-            for (io::usize i = n; i > 0; --i) // reverse order is usually safer
-                p[i - 1].~T();
+        Alloc& alloc() noexcept { return *this; }
+
+        // Trivially relocatable: the allocator resizes the bytes (large heap
+        // buffers are remapped by the kernel, not copied).
+        T* grow(usize target, true_t) noexcept {
+            return static_cast<T*>(alloc().reallocate(_ptr, _cap * sizeof(T), target * sizeof(T), alignof(T)));
+        }
+
+        T* grow(usize target, false_t) noexcept {
+            // Allocate raw bytes for T[target]
+            T* new_ptr = static_cast<T*>(alloc().allocate(target * sizeof(T), alignof(T)));
+            if (!new_ptr) return nullptr;
+
+            native::relocate(new_ptr, _ptr, _len); // one memcpy for trivial T
+            release(); // old bytes
+            return new_ptr;
+        }
+
+        // Returns the buffer to the allocator; elements must be destroyed already.
+        void release() noexcept {
+            if (_ptr) alloc().deallocate(_ptr, _cap * sizeof(T), alignof(T));
+            _ptr = nullptr;
+            _cap = 0;
         }
     }; // struct vector
 
 
 
+    // ------------------------- small_vector ----------------------------
+    // vector with room for N elements inside the object: it allocates only
+    // once it grows past N, and never returns to inline storage after that.
+    // Moving an inline small_vector moves its elements one by one (a memcpy
+    // for trivially relocatable T).
+    template<typename T, usize N, typename Alloc = heap_allocator>
+    struct small_vector : private Alloc {
+        static_assert(N > 0, "small_vector needs inline capacity; use io::vector");
 
+        using value_type = T;
+        using allocator_type = Alloc;
+        static IO_CONSTEXPR_VAR usize INLINE_CAPACITY = N;
 
-    template<class CharT>
-    struct basic_string {
-        using view_t = io::view<const CharT>;
+        small_vector() noexcept : _ptr(inline_ptr()) {}
+        explicit small_vector(const Alloc& a) noexcept : Alloc(a), _ptr(inline_ptr()) {}
 
-        io::vector<CharT> v;
+        ~small_vector() noexcept {
+            native::destroy(_ptr, _len);
+            release();
+            _len = 0;
+        }
+
+        small_vector(const small_vector&) = delete;
+        small_vector& operator=(const small_vector&) = delete;
 
-        IO_CONSTEXPR basic_string() noexcept {
-            v.push_back(CharT(0));
-            v.set_size_unsafe(1);
+        small_vector(small_vector&& o) noexcept : Alloc(static_cast<Alloc&&>(o)), _ptr(inline_ptr()) {
+            if (o.is_inline()) {
+                native::relocate(_ptr, o._ptr, o._len);
+            }
+            else {
+                _ptr = o._ptr;
+                _cap = o._cap;
+                o._ptr = o.inline_ptr();
+                o._cap = N;
+            }
+            _len = o._len;
+            o._len = 0;
         }
 
+        small_vector& operator=(small_vector&& o) noexcept {
+            if (this == &o) return *this;
+            this->~small_vector();
+            new (this) small_vector(static_cast<small_vector&&>(o));
+            return *this;
+        }
+
+        IO_NODISCARD const Alloc& get_allocator() const noexcept { return *this; }
+
+        // -------- view conversion --------
+        IO_NODISCARD view<T> as_view() noexcept { return view<T>(_ptr, _len); }
+        IO_NODISCARD view<const T> as_view() const noexcept { return view<const T>(_ptr, _len); }
+
+        // -------- capacity/size --------
+        IO_NODISCARD usize size() const noexcept { return _len; }
+        IO_NODISCARD usize capacity() const noexcept { return _cap; }
+        IO_NODISCARD bool empty() const noexcept { return _len == 0; }
+        // Elements still live inside the object (nothing allocated).
+        IO_NODISCARD bool is_inline() const noexcept { return _ptr == inline_ptr(); }
+
+        // -------- iterators --------
+        IO_NODISCARD T* begin() noexcept { return _ptr; }
+        IO_NODISCARD T* end() noexcept { return _ptr + _len; }
+        IO_NODISCARD const T* begin() const noexcept { return _ptr; }
+        IO_NODISCARD const T* end() const noexcept { return _ptr + _len; }
+
+        // -------- data --------
+        IO_NODISCARD T* data() noexcept { return _ptr; }
+        IO_NODISCARD const T* data() const noexcept { return _ptr; }
+
+        // -------- element access --------
+        IO_NODISCARD T& operator[](usize i) noexcept { return _ptr[i]; }
+        IO_NODISCARD const T& operator[](usize i) const noexcept { return _ptr[i]; }
+
+        IO_NODISCARD T& front() noexcept { return _ptr[0]; }
+        IO_NODISCARD T& back() noexcept { return _ptr[_len - 1]; }
+        IO_NODISCARD const T& front() const noexcept { return _ptr[0]; }
+        IO_NODISCARD const T& back() const noexcept { return _ptr[_len - 1]; }
+
+        // -------- reserve / resize --------
+        IO_NODISCARD bool reserve(usize new_cap) noexcept {
+            if (new_cap <= _cap) return true;
+
+            usize target = _cap * 2;
+            if (target < new_cap) target = new_cap;
+
+            T* new_ptr = is_inline()
+                ? spill(target)
+                : grow(target, constant<bool, is_trivially_relocatable_v<T> && has_reallocate<Alloc>::value>{});
+            if (!new_ptr) return false;
+            _ptr = new_ptr;
+            _cap = target;
+            return true;
+        }
+
+        // resize to n (value-initialize new elems)
+        IO_NODISCARD bool resize(usize n) noexcept {
+            if (n > _cap) {
+                if (!reserve(n)) return false;
+            }
+
+            if (n > _len) native::value_init(_ptr + _len, n - _len);
+            else native::destroy(_ptr + n, _len - n);
+            _len = n;
+            return true;
+        }
+
+        // resize to n, default-initializing new elems (see vector)
+        IO_NODISCARD bool resize_for_overwrite(usize n) noexcept {
+            if (n > _cap) {
+                if (!reserve(n)) return false;
+            }
+
+            for (usize i = _len; i < n; ++i) new (_ptr + i) T;
+            if (n < _len) native::destroy(_ptr + n, _len - n);
+            _len = n;
+            return true;
+        }
+
+        // -------- modifiers --------
+        IO_NODISCARD bool push_back(const T& v) noexcept {
+            if (_len == _cap && !reserve(_len + 1)) return false;
+            new (_ptr + _len) T(v);
+            ++_len;
+            return true;
+        }
+
+        IO_NODISCARD bool push_back(T&& v) noexcept {
+            if (_len == _cap && !reserve(_len + 1)) return false;
+            new (_ptr + _len) T(io::move(v));
+            ++_len;
+            return true;
+        }
+
+        void pop_back() noexcept {
+            if (_len == 0) return;
+            --_len;
+            _ptr[_len].~T();
+        }
+
+        void clear() noexcept {
+            native::destroy(_ptr, _len);
+            _len = 0;
+        }
+
+        void set_size_unsafe(usize n) noexcept {
+            // Caller promises elements [0..n) are constructed.
+            _len = (n <= _cap) ? n : _len;
+        }
+
+    private:
+        T* _ptr;            // inline_ptr() or _cap * sizeof(T) bytes from Alloc
+        usize _len{ 0 };
+        usize _cap{ N };
+        alignas(T) unsigned char _inline[N * sizeof(T)];
+
+        Alloc& alloc() noexcept { return *this; }
+
+        T* inline_ptr() noexcept { return reinterpret_cast<T*>(_inline); }
+        const T* inline_ptr() const noexcept { return reinterpret_cast<const T*>(_inline); }
+
+        // First heap buffer: the inline elements move out.
+        T* spill(usize target) noexcept {
+            T* new_ptr = static_cast<T*>(alloc().allocate(target * sizeof(T), alignof(T)));
+            if (!new_ptr) return nullptr;
+            native::relocate(new_ptr, _ptr, _len);
+            return new_ptr;
+        }
+
+        T* grow(usize target, true_t) noexcept {
+            return static_cast<T*>(alloc().reallocate(_ptr, _cap * sizeof(T), target * sizeof(T), alignof(T)));
+        }
+
+        T* grow(usize target, false_t) noexcept {
+            T* new_ptr = static_cast<T*>(alloc().allocate(target * sizeof(T), alignof(T)));
+            if (!new_ptr) return nullptr;
+
+            native::relocate(new_ptr, _ptr, _len);
+            release();
+            return new_ptr;
+        }
+
+        // Frees a heap buffer, if any; elements must be destroyed already.
+        void release() noexcept {
+            if (!is_inline()) alloc().deallocate(_ptr, _cap * sizeof(T), alignof(T));
+            _ptr = inline_ptr();
+            _cap = N;
+        }
+    }; // struct small_vector
+
+
+
+
+
+    // ------------------------- basic_string ----------------------------
+    // Always NUL-terminated. Up to SSO_CAPACITY characters (23 for char on
+    // 64-bit targets) are stored inside the object, so empty and short strings
+    // never allocate; longer ones own a heap buffer from Alloc.
+    //
+    // Layout: the last inline CharT doubles as the mode tag. A short string
+    // keeps `SSO_CAPACITY - size` there (0 when full, so it is also the
+    // terminator); a long string sets the top bit of `cap`, which occupies
+    // the same bytes on little-endian targets.
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#   error "io::basic_string's inline layout assumes a little-endian target"
+#endif
+    template<class CharT, typename Alloc = heap_allocator>
+    struct basic_string : private Alloc {
+        using view_t = io::view<const CharT>;
+        using value_type = CharT;
+        using allocator_type = Alloc;
+
+    private:
+        struct Long {
+            CharT* ptr;
+            usize  len;
+            usize  cap; // | LONG_FLAG
+        };
+
+    public:
+        static IO_CONSTEXPR_VAR usize SSO_CAPACITY = sizeof(Long) / sizeof(CharT) - 1;
+
+        basic_string() noexcept { set_short_size(0); }
+        explicit basic_string(const Alloc& a) noexcept : Alloc(a) { set_short_size(0); }
+
+        ~basic_string() noexcept { release(); }
+
         basic_string(const basic_string&) = delete;
         basic_string& operator=(const basic_string&) = delete;
 
-        basic_string(basic_string&& o) noexcept : v(static_cast<io::vector<CharT>&&>(o.v)) {}
-        basic_string& operator=(basic_string&& o) noexcept { v = static_cast<io::vector<CharT>&&>(o.v); return *this; }
+        basic_string(basic_string&& o) noexcept : Alloc(static_cast<Alloc&&>(o)) {
+            IO_MEMCPY(static_cast<void*>(&_l), static_cast<const void*>(&o._l), sizeof(Long));
+            o.set_short_size(0);
+        }
+        basic_string& operator=(basic_string&& o) noexcept {
+            if (this == &o) return *this;
+            this->~basic_string();
+            new (this) basic_string(static_cast<basic_string&&>(o));
+            return *this;
+        }
 
         // from view
-        explicit basic_string(view<const CharT> s) noexcept {
-            init_empty();
-            append(s);
+        explicit basic_string(view<const CharT> s, const Alloc& a = Alloc{}) noexcept : Alloc(a) {
+            set_short_size(0);
+            (void)append(s);
         }
 
         // from zero-terminated
-        explicit basic_string(const CharT* s) noexcept {
-            init_empty();
+        explicit basic_string(const CharT* s, const Alloc& a = Alloc{}) noexcept : Alloc(a) {
+            set_short_size(0);
             if (!s) return;
-            append_cstr(s);
+            (void)append_cstr(s);
         }
 
-        IO_NODISCARD usize size() const noexcept {
-            const usize n = v.size();
-            return n ? (n - 1) : 0; // without '\0'
+        IO_NODISCARD const Alloc& get_allocator() const noexcept { return *this; }
+
+        IO_NODISCARD usize size() const noexcept { // without '\0'
+            return is_long() ? _l.len : SSO_CAPACITY - static_cast<usize>(_s[SSO_CAPACITY]);
+        }
+        IO_NODISCARD usize capacity() const noexcept {
+            return is_long() ? (_l.cap & ~LONG_FLAG) : SSO_CAPACITY;
         }
         IO_NODISCARD bool empty() const noexcept { return size() == 0; }
 
-        IO_NODISCARD const CharT* c_str() const noexcept { return v.data() ? v.data() : zlit(); }
-        IO_NODISCARD CharT* data() noexcept { return v.data(); }
-        IO_NODISCARD const CharT* data() const noexcept { return c_str(); }
+        IO_NODISCARD const CharT* c_str() const noexcept { return ptr(); }
+        IO_NODISCARD CharT* data() noexcept { return ptr(); }
+        IO_NODISCARD const CharT* data() const noexcept { return ptr(); }
 
-        IO_NODISCARD CharT& operator[](usize i) noexcept { return v[i]; }
-        IO_NODISCARD const CharT& operator[](usize i) const noexcept { return v[i]; }
+        IO_NODISCARD CharT& operator[](usize i) noexcept { return ptr()[i]; }
+        IO_NODISCARD const CharT& operator[](usize i) const noexcept { return ptr()[i]; }
 
-        IO_NODISCARD view<const CharT> as_view() const noexcept { return view<const CharT>(v.data(), size()); }
-        IO_NODISCARD view<CharT> as_mut_view() noexcept { return view<CharT>(v.data(), size()); }
+        IO_NODISCARD view<const CharT> as_view() const noexcept { return view<const CharT>(ptr(), size()); }
+        IO_NODISCARD view<CharT> as_mut_view() noexcept { return view<CharT>(ptr(), size()); }
 
-        IO_NODISCARD bool reserve(usize n) noexcept { return v.reserve(n + 1); }
+        // Room for `n` characters plus the terminator.
+        IO_NODISCARD bool reserve(usize n) noexcept {
+            const usize cap = capacity();
+            if (n <= cap) return true;
 
-        void clear() noexcept {
-            v.clear();
-            v.push_back(CharT(0));
-            v.set_size_unsafe(1);
+            usize target = cap * 2;
+            if (target < n) target = n;
+            return grow(target, has_reallocate<Alloc>{});
         }
 
+        void clear() noexcept { set_size(0); }
+
         IO_NODISCARD bool resize(usize n, CharT fill = CharT(0)) noexcept {
             const usize old = size();
-            if (!ensure_terminator()) return false;
-
-            if (n < old) {
-                if (!v.resize(n + 1)) return false;
-                v[n] = CharT(0);
-                return true;
-            }
-
             if (n > old) {
-                if (!v.resize(n + 1)) return false;
-                for (usize i = old; i < n; ++i) v[i] = fill;
-                v[n] = CharT(0);
+                if (!reserve(n)) return false;
+                CharT* p = ptr();
+                if (sizeof(CharT) == 1) IO_MEMSET(p + old, static_cast<int>(fill), n - old);
+                else for (usize i = old; i < n; ++i) p[i] = fill;
             }
+            set_size(n);
             return true;
         }
 
+        // resize without filling: new characters are garbage until the caller
+        // writes them (e.g. as a read target); only the terminator is set
+        IO_NODISCARD bool resize_for_overwrite(usize n) noexcept {
+            if (n > size() && !reserve(n)) return false;
+            set_size(n);
+            return true;
+        }
+
+        // Amortized O(1): capacity doubles, the common case is one store.
         IO_NODISCARD bool push_back(CharT ch) noexcept {
+            if (is_long()) {
+                if (_l.len < (_l.cap & ~LONG_FLAG)) {
+                    _l.ptr[_l.len++] = ch;
+                    _l.ptr[_l.len] = CharT(0);
+                    return true;
+                }
+            }
+            else {
+                const usize n = SSO_CAPACITY - static_cast<usize>(_s[SSO_CAPACITY]);
+                if (n < SSO_CAPACITY) {
+                    _s[n] = ch;
+                    set_short_size(n + 1);
+                    return true;
+                }
+            }
+
             const usize n = size();
-            if (!ensure_terminator()) return false;
-            if (!v.resize(n + 2)) return false;
-            v[n] = ch;
-            v[n + 1] = CharT(0);
+            if (!reserve(n + 1)) return false;
+            ptr()[n] = ch;
+            set_size(n + 1);
             return true;
         }
 
         IO_NODISCARD bool append(view<const CharT> s) noexcept {
             if (s.size() == 0) return true;
             const usize n = size();
-            if (!ensure_terminator()) return false;
 
-            if (!v.resize(n + s.size() + 1)) return false;
-            for (usize i = 0; i < s.size(); ++i) v[n + i] = s[i];
-            v[n + s.size()] = CharT(0);
+            // `s` may point into this string; re-base it if the buffer moves
+            const CharT* src = s.data();
+            const CharT* old = ptr();
+            const bool inside = src >= old && src <= old + n;
+            if (!reserve(n + s.size())) return false;
+            if (inside) src = ptr() + (src - old);
+
+            IO_MEMCPY(ptr() + n, src, s.size() * sizeof(CharT));
+            set_size(n + s.size());
             return true;
         }
         IO_NODISCARD bool append(const CharT* s) noexcept {
             if (!s) return true;
             return append_cstr(s);
         }
-        IO_NODISCARD bool append(const basic_string<CharT>& r) noexcept {
-            if (!r.data()) return true;
-            return append_cstr(r.c_str());
+        template <typename A>
+        IO_NODISCARD bool append(const basic_string<CharT, A>& r) noexcept {
+            return append(r.as_view());
         }
-        IO_NODISCARD bool append(const vector<CharT>& v) noexcept {
+        template <typename A>
+        IO_NODISCARD bool append(const vector<CharT, A>& v) noexcept {
             if (!v.data()) return true;
             return append_cstr(v.data());
         }
@@ -271,21 +592,15 @@ namespace io {
             return true;
         }
 
-        IO_NODISCARD bool split(CharT delim, vector<view_t>& out_parts) const noexcept {
-            out_parts.clear();
-            view_t s = as_view();
+        template <typename A>
+        IO_NODISCARD bool split(CharT delim, vector<view_t, A>& out_parts) const noexcept {
+            return split_into(delim, out_parts);
+        }
 
-            usize start = 0;
-            for (usize i = 0; i < s.size(); ++i) {
-                if (s[i] == delim) {
-                    if (!out_parts.push_back(
-                        view_t{ s.data()+start, i-start })) return false;
-                    start = i + 1;
-                }
-            }
-            if (!out_parts.push_back(
-                view_t{ s.data()+start, s.size()-start })) return false;
-            return true;
+        // Short paths split without touching the heap.
+        template <usize N, typename A>
+        IO_NODISCARD bool split(CharT delim, small_vector<view_t, N, A>& out_parts) const noexcept {
+            return split_into(delim, out_parts);
         }
 
         static IO_NODISCARD bool join(view<view_t> parts, view_t delim, basic_string& out) noexcept {
@@ -307,23 +622,78 @@ namespace io {
         }
 
     private:
-        static const CharT* zlit() noexcept {
-            static const CharT z[1] = { CharT(0) };
-            return z;
+        // vector or small_vector of views
+        template <typename Parts>
+        IO_NODISCARD bool split_into(CharT delim, Parts& out_parts) const noexcept {
+            out_parts.clear();
+            view_t s = as_view();
+
+            usize start = 0;
+            for (;;) {
+                const usize i = s.find(delim, start); // memchr-style for char
+                if (i == view_t::npos) break;
+                if (!out_parts.push_back(
+                    view_t{ s.data()+start, i-start })) return false;
+                start = i + 1;
+            }
+            if (!out_parts.push_back(
+                view_t{ s.data()+start, s.size()-start })) return false;
+            return true;
         }
 
-        void init_empty() noexcept {
-            v.clear();
-            v.push_back(CharT(0));
-            v.set_size_unsafe(1);
+        static IO_CONSTEXPR_VAR usize LONG_FLAG = usize(1) << (sizeof(usize) * 8 - 1);
+
+        union {
+            Long  _l;
+            CharT _s[sizeof(Long) / sizeof(CharT)]; // SSO_CAPACITY chars + tag
+        };
+
+        Alloc& alloc() noexcept { return *this; }
+
+        IO_NODISCARD bool is_long() const noexcept { return (_l.cap & LONG_FLAG) != 0; }
+
+        IO_NODISCARD CharT* ptr() noexcept { return is_long() ? _l.ptr : _s; }
+        IO_NODISCARD const CharT* ptr() const noexcept { return is_long() ? _l.ptr : _s; }
+
+        void set_short_size(usize n) noexcept {
+            _s[n] = CharT(0);
+            _s[SSO_CAPACITY] = static_cast<CharT>(SSO_CAPACITY - n);
+        }
+
+        void set_size(usize n) noexcept {
+            if (!is_long()) { set_short_size(n); return; }
+            _l.len = n;
+            _l.ptr[n] = CharT(0);
+        }
+
+        // Long buffer for `target` chars + '\0'; the contents move over.
+        IO_NODISCARD bool grow(usize target, true_t) noexcept {
+            if (!is_long()) return grow(target, false_t{});
+            void* p = alloc().reallocate(_l.ptr, (capacity() + 1) * sizeof(CharT),
+                                         (target + 1) * sizeof(CharT), alignof(CharT));
+            if (!p) return false;
+            _l.ptr = static_cast<CharT*>(p);
+            _l.cap = target | LONG_FLAG;
+            return true;
         }
 
-        IO_NODISCARD bool ensure_terminator() noexcept {
-            if (v.size() == 0) return v.push_back(CharT(0));
-            if (v[v.size() - 1] != CharT(0)) return v.push_back(CharT(0));
+        IO_NODISCARD bool grow(usize target, false_t) noexcept {
+            CharT* p = static_cast<CharT*>(alloc().allocate((target + 1) * sizeof(CharT), alignof(CharT)));
+            if (!p) return false;
+            const usize n = size();
+            IO_MEMCPY(p, ptr(), (n + 1) * sizeof(CharT));
+            release();
+            _l.ptr = p;
+            _l.len = n;
+            _l.cap = target | LONG_FLAG;
             return true;
         }
 
+        // Frees a long buffer; the representation is left for the caller to set.
+        void release() noexcept {
+            if (is_long()) alloc().deallocate(_l.ptr, (capacity() + 1) * sizeof(CharT), alignof(CharT));
+        }
+
         IO_NODISCARD bool append_cstr(const CharT* s) noexcept {
             usize n = 0;
             while (s[n] != CharT(0)) ++n;
@@ -340,30 +710,37 @@ namespace io {
 
 
 
-    template<typename T>
-    struct deque {
+    // Block map plus fixed-size blocks of BLOCK elements. Positions form a
+    // ring of `map_cap * BLOCK` slots laid over the map, so an access is two
+    // masks and a shift. Growth reallocates only the map of block pointers:
+    // elements never move, and references stay valid until the element is
+    // popped. Blocks emptied by pops are kept for reuse and freed with the deque.
+    template<typename T, typename Alloc = heap_allocator>
+    struct deque : private Alloc {
         using value_type = T;
+        using allocator_type = Alloc;
+
+        // Elements per block: a power of two, at least 16.
+        static IO_CONSTEXPR_VAR usize BLOCK_SHIFT = native::floor_log2(
+            IO_DEQUE_BLOCK_BYTES / sizeof(T) < 16 ? 16 : IO_DEQUE_BLOCK_BYTES / sizeof(T));
+        static IO_CONSTEXPR_VAR usize BLOCK = usize(1) << BLOCK_SHIFT;
 
         IO_CONSTEXPR deque() noexcept = default;
+        explicit deque(const Alloc& a) noexcept : Alloc(a) {}
 
         ~deque() noexcept {
             clear();
-            _raw.reset(nullptr);
-            _buf = nullptr;
-            _cap = 0;
-            _len = 0;
-            _front = 0;
+            release();
         }
 
         deque(const deque&) = delete;
         deque& operator=(const deque&) = delete;
 
-        deque(deque&& o) noexcept {
-            _raw = static_cast<unique_bytes&&>(o._raw);
-            _buf = o._buf;      o._buf = nullptr;
-            _cap = o._cap;      o._cap = 0;
-            _len = o._len;      o._len = 0;
-            _front = o._front;  o._front = 0;
+        deque(deque&& o) noexcept : Alloc(static_cast<Alloc&&>(o)) {
+            _map = o._map;          o._map = nullptr;
+            _map_cap = o._map_cap;  o._map_cap = 0;
+            _len = o._len;          o._len = 0;
+            _front = o._front;      o._front = 0;
         }
 
         deque& operator=(deque&& o) noexcept {
@@ -373,14 +750,17 @@ namespace io {
             return *this;
         }
 
+        IO_NODISCARD const Alloc& get_allocator() const noexcept { return *this; }
+
         // ---- size/capacity ----
         IO_NODISCARD io::usize size() const noexcept { return _len; }
-        IO_NODISCARD io::usize capacity() const noexcept { return _cap; }
+        // Positions addressable before the block map has to grow.
+        IO_NODISCARD io::usize capacity() const noexcept { return _map_cap << BLOCK_SHIFT; }
         IO_NODISCARD bool empty() const noexcept { return _len == 0; }
 
         // ---- element access ----
-        IO_NODISCARD T& operator[](io::usize i) noexcept { return _buf[idx(i)]; }
-        IO_NODISCARD const T& operator[](io::usize i) const noexcept { return _buf[idx(i)]; }
+        IO_NODISCARD T& operator[](io::usize i) noexcept { return *slot(i); }
+        IO_NODISCARD const T& operator[](io::usize i) const noexcept { return *slot(i); }
 
         IO_NODISCARD T& front() noexcept { return (*this)[0]; }
         IO_NODISCARD const T& front() const noexcept { return (*this)[0]; }
@@ -389,102 +769,183 @@ namespace io {
         IO_NODISCARD const T& back() const noexcept { return (*this)[_len - 1]; }
 
         // ---- modifiers ----
+        // Maps and allocates blocks so that pushing back up to `new_cap`
+        // elements in total will not allocate.
         IO_NODISCARD bool reserve(io::usize new_cap) noexcept {
-            if (new_cap <= _cap) return true;
-
-            io::usize target = _cap ? (_cap * 2) : 8;
-            if (target < new_cap) target = new_cap;
-
-            io::u8* new_raw = static_cast<io::u8*>(::operator new[](target * sizeof(T)));
-            if (!new_raw) return false;
-
-            T* new_buf = reinterpret_cast<T*>(new_raw);
-
-            // move existing items in logical order into [0.._len)
-            for (io::usize i = 0; i < _len; ++i) {
-                new (new_buf + i) T(io::move((*this)[i]));
-                (*this)[i].~T();
-            }
-
-            _raw.reset(new_raw);
-            _buf = new_buf;
-            _cap = target;
-            _front = 0;
-            return true;
+            return new_cap <= _len || reserve_back(new_cap - _len);
         }
 
         IO_NODISCARD bool push_back(const T& v) noexcept {
-            if (_len == _cap && !reserve(_len + 1)) return false;
-            // after reserve, _cap > 0 is guaranteed
-            new (_buf + idx(_len)) T(v);
+            if (!reserve_back(1)) return false;
+            new (slot(_len)) T(v);
             ++_len;
             return true;
         }
 
         IO_NODISCARD bool push_back(T&& v) noexcept {
-            if (_len == _cap && !reserve(_len + 1)) return false;
-            new (_buf + idx(_len)) T(io::move(v));
+            if (!reserve_back(1)) return false;
+            new (slot(_len)) T(io::move(v));
             ++_len;
             return true;
         }
 
         IO_NODISCARD bool push_front(const T& v) noexcept {
-            if (_len == _cap && !reserve(_len + 1)) return false;
-            dec_front();
-            new (_buf + _front) T(v);
+            if (!reserve_front()) return false;
+            new (slot(BEFORE_FRONT)) T(v);
+            _front = (_front - 1) & mask();
             ++_len;
             return true;
         }
 
         IO_NODISCARD bool push_front(T&& v) noexcept {
-            if (_len == _cap && !reserve(_len + 1)) return false;
-            dec_front();
-            new (_buf + _front) T(io::move(v));
+            if (!reserve_front()) return false;
+            new (slot(BEFORE_FRONT)) T(io::move(v));
+            _front = (_front - 1) & mask();
             ++_len;
             return true;
         }
 
+        // Copies `src` to the back, a block-sized run at a time (memcpy for
+        // trivially copyable T). Nothing is added if allocation fails.
+        IO_NODISCARD bool push_back_range(view<const T> src) noexcept {
+            if (!reserve_back(src.size())) return false;
+            const T* from = src.data();
+            for_each_run(_len, src.size(), [&](T* p, usize n) noexcept {
+                native::copy_init(p, from, n);
+                from += n;
+            });
+            _len += src.size();
+            return true;
+        }
+
         void pop_back() noexcept {
             if (_len == 0) return;
-            io::usize bi = idx(_len - 1);
-            _buf[bi].~T();
+            slot(_len - 1)->~T();
             --_len;
-            if (_len == 0) _front = 0;
         }
 
         void pop_front() noexcept {
             if (_len == 0) return;
-            _buf[_front].~T();
-            _front = (_front + 1) % _cap; // _cap>0 because _len>0
+            slot(0)->~T();
+            _front = (_front + 1) & mask();
             --_len;
-            if (_len == 0) _front = 0;
         }
 
+        // Destroys up to `n` elements from the front; returns how many.
+        io::usize pop_front_n(io::usize n) noexcept {
+            if (n > _len) n = _len;
+            for_each_run(0, n, [](T* p, usize k) noexcept { native::destroy(p, k); });
+            advance_front(n);
+            return n;
+        }
+
+        // Moves up to `n` front elements into uninitialized `out` (in order)
+        // and removes them; returns how many.
+        io::usize pop_front_n(T* out, io::usize n) noexcept {
+            if (n > _len) n = _len;
+            for_each_run(0, n, [&](T* p, usize k) noexcept {
+                native::relocate(out, p, k);
+                out += k;
+            });
+            advance_front(n);
+            return n;
+        }
+
+        // Destroys the elements; blocks stay allocated for reuse.
         void clear() noexcept {
-            if (!_buf || _len == 0) { _len = 0; _front = 0; return; }
-            for (io::usize i = 0; i < _len; ++i) {
-                (*this)[i].~T();
-            }
+            if (!is_trivially_destructible_v<T>)
+                for_each_run(0, _len, [](T* p, usize k) noexcept { native::destroy(p, k); });
             _len = 0;
             _front = 0;
         }
 
     private:
-        unique_bytes _raw{};
-        T* _buf{ nullptr };
-        io::usize _cap{ 0 };
+        T** _map{ nullptr }; // _map_cap block pointers (power of two); null until used
+        io::usize _map_cap{ 0 };
         io::usize _len{ 0 };
-        io::usize _front{ 0 };
+        io::usize _front{ 0 }; // ring position of element 0, < capacity()
+
+        // slot(BEFORE_FRONT) is the position push_front fills
+        static IO_CONSTEXPR_VAR usize BEFORE_FRONT = static_cast<usize>(-1);
+
+        Alloc& alloc() noexcept { return *this; }
+
+        IO_NODISCARD usize mask() const noexcept { return (_map_cap << BLOCK_SHIFT) - 1; }
+
+        IO_NODISCARD T* slot(usize i) const noexcept {
+            const usize at = (_front + i) & mask();
+            return _map[at >> BLOCK_SHIFT] + (at & (BLOCK - 1));
+        }
+
+        void advance_front(usize n) noexcept {
+            _front = (_front + n) & mask();
+            _len -= n;
+        }
+
+        // Calls f(ptr, count) for each in-block run of elements [i, i + n).
+        template<typename F>
+        void for_each_run(usize i, usize n, F&& f) const noexcept {
+            while (n) {
+                const usize room = BLOCK - ((_front + i) & (BLOCK - 1));
+                const usize k = n < room ? n : room;
+                f(slot(i), k);
+                i += k;
+                n -= k;
+            }
+        }
+
+        IO_NODISCARD bool ensure_block(usize b) noexcept {
+            if (_map[b]) return true;
+            _map[b] = static_cast<T*>(alloc().allocate(BLOCK * sizeof(T), alignof(T)));
+            return _map[b] != nullptr;
+        }
 
-        IO_NODISCARD io::usize idx(io::usize i) const noexcept {
-            // valid only when _cap > 0 (i.e., after first reserve)
-            // public operations guarantee this when _len>0 or when pushing
-            return (_front + i) % _cap;
+        // The ring must span `slots` positions from the start of the front
+        // block without the back reaching that block again.
+        IO_NODISCARD bool fit(usize slots) noexcept {
+            const usize blocks = (slots + BLOCK - 1) >> BLOCK_SHIFT;
+            return blocks <= _map_cap || grow_map(blocks);
         }
 
-        void dec_front() noexcept {
-            // called only when _cap > 0
-            _front = (_front == 0) ? (_cap - 1) : (_front - 1);
+        // Doubles the map; the block pointers are unrolled so the front
+        // block is first. No element moves.
+        IO_NODISCARD bool grow_map(usize blocks) noexcept {
+            usize cap = _map_cap ? _map_cap * 2 : 8;
+            while (cap < blocks) cap *= 2;
+            T** m = static_cast<T**>(alloc().allocate(cap * sizeof(T*), alignof(T*)));
+            if (!m) return false;
+
+            const usize first = _front >> BLOCK_SHIFT;
+            for (usize k = 0; k < _map_cap; ++k) m[k] = _map[(first + k) & (_map_cap - 1)];
+            for (usize k = _map_cap; k < cap; ++k) m[k] = nullptr;
+            if (_map) alloc().deallocate(_map, _map_cap * sizeof(T*), alignof(T*));
+            _map = m;
+            _map_cap = cap;
+            _front &= BLOCK - 1;
+            return true;
+        }
+
+        IO_NODISCARD bool reserve_back(usize extra) noexcept {
+            if (extra == 0) return true;
+            if (!fit((_front & (BLOCK - 1)) + _len + extra)) return false;
+            const usize last = (_front + _len + extra - 1) >> BLOCK_SHIFT;
+            for (usize b = (_front + _len) >> BLOCK_SHIFT; b <= last; ++b)
+                if (!ensure_block(b & (_map_cap - 1))) return false;
+            return true;
+        }
+
+        IO_NODISCARD bool reserve_front() noexcept {
+            const usize off = _front & (BLOCK - 1);
+            if (!fit((off ? off - 1 : BLOCK - 1) + _len + 1)) return false;
+            return ensure_block(((_front - 1) & mask()) >> BLOCK_SHIFT);
+        }
+
+        void release() noexcept {
+            for (usize k = 0; k < _map_cap; ++k)
+                if (_map[k]) alloc().deallocate(_map[k], BLOCK * sizeof(T), alignof(T));
+            if (_map) alloc().deallocate(_map, _map_cap * sizeof(T*), alignof(T*));
+            _map = nullptr;
+            _map_cap = 0;
         }
     }; // struct deque
 
@@ -495,9 +956,14 @@ namespace io {
 
 
 
-    template<typename T>
-    struct list {
+    // Nodes are carved from slabs owned by the list and recycled through a
+    // free list, so push/erase churn reaches the allocator only when the list
+    // outgrows every node it has had. Slabs are freed by shrink_to_fit() once
+    // the list is empty, or with the list.
+    template<typename T, typename Alloc = heap_allocator>
+    struct list : private Alloc {
         using value_type = T;
+        using allocator_type = Alloc;
 
         struct node {
             node* prev;
@@ -537,17 +1003,27 @@ namespace io {
         };
 
         IO_CONSTEXPR list() noexcept = default;
-        ~list() noexcept { clear(); }
+        explicit list(const Alloc& a) noexcept : Alloc(a) {}
+        ~list() noexcept {
+            clear();
+            release();
+        }
 
         list(const list&) = delete;
         list& operator=(const list&) = delete;
 
-        list(list&& o) noexcept {
+        list(list&& o) noexcept : Alloc(static_cast<Alloc&&>(o)) {
             _head = o._head;
             _tail = o._tail;
             _len = o._len;
+            _slabs = o._slabs;
+            _free = o._free;
+            _spare = o._spare;
             o._head = o._tail = nullptr;
             o._len = 0;
+            o._slabs = nullptr;
+            o._free = nullptr;
+            o._spare = 0;
         }
 
         list& operator=(list&& o) noexcept {
@@ -557,9 +1033,23 @@ namespace io {
             return *this;
         }
 
+        IO_NODISCARD const Alloc& get_allocator() const noexcept { return *this; }
+
         // ---- size ----
         IO_NODISCARD usize size() const noexcept { return _len; }
         IO_NODISCARD bool empty() const noexcept { return _len == 0; }
+        // Elements the list can hold before carving another slab.
+        IO_NODISCARD usize capacity() const noexcept { return _len + _spare; }
+
+        // Carves one slab large enough that `n` elements fit without allocating.
+        IO_NODISCARD bool reserve(usize n) noexcept {
+            return n <= _len + _spare || add_slab(n - _len - _spare);
+        }
+
+        // Frees the node slabs once the list is empty; no-op otherwise.
+        void shrink_to_fit() noexcept {
+            if (_len == 0) release();
+        }
 
         // ---- iterators ----
         iterator begin() noexcept { return iterator{ _head }; }
@@ -635,14 +1125,69 @@ namespace io {
         }
 
     private:
+        // Slab header; `count` nodes follow at SLAB_HEAD bytes.
+        struct slab {
+            slab* next;
+            usize count;
+        };
+        // Link stored in a node's bytes while it is on the free list.
+        struct free_node {
+            free_node* next;
+        };
+
+        static IO_CONSTEXPR_VAR usize SLAB_ALIGN = alignof(node) > alignof(slab) ? alignof(node) : alignof(slab);
+        static IO_CONSTEXPR_VAR usize SLAB_HEAD = (sizeof(slab) + alignof(node) - 1) / alignof(node) * alignof(node);
+        // Slabs double from 8 nodes up to about a page.
+        static IO_CONSTEXPR_VAR usize SLAB_MIN = 8;
+        static IO_CONSTEXPR_VAR usize SLAB_MAX = 4096 / sizeof(node) > SLAB_MIN ? 4096 / sizeof(node) : SLAB_MIN;
+
         node* _head{ nullptr };
         node* _tail{ nullptr };
         usize _len{ 0 };
+        slab* _slabs{ nullptr };     // newest first
+        free_node* _free{ nullptr }; // unconstructed nodes, LIFO
+        usize _spare{ 0 };           // nodes on _free
+
+        Alloc& alloc() noexcept { return *this; }
+
+        static usize slab_bytes(usize count) noexcept { return SLAB_HEAD + count * sizeof(node); }
+
+        // Allocates a slab of at least `want` nodes and threads them onto
+        // the free list in address order.
+        IO_NODISCARD bool add_slab(usize want) noexcept {
+            usize count = _slabs ? _slabs->count * 2 : SLAB_MIN;
+            if (count > SLAB_MAX) count = SLAB_MAX;
+            if (count < want) count = want;
+
+            slab* s = static_cast<slab*>(alloc().allocate(slab_bytes(count), SLAB_ALIGN));
+            if (!s) return false;
+            s->next = _slabs;
+            s->count = count;
+            _slabs = s;
+
+            char* nodes = reinterpret_cast<char*>(s) + SLAB_HEAD;
+            for (usize i = count; i > 0; --i)
+                _free = new (nodes + (i - 1) * sizeof(node)) free_node{ _free };
+            _spare += count;
+            return true;
+        }
+
+        void release() noexcept {
+            while (_slabs) {
+                slab* nx = _slabs->next;
+                alloc().deallocate(_slabs, slab_bytes(_slabs->count), SLAB_ALIGN);
+                _slabs = nx;
+            }
+            _free = nullptr;
+            _spare = 0;
+        }
 
         template<class U>
         node* make_node(U&& v) noexcept {
-            void* mem = ::operator new(sizeof(node), std::nothrow);
-            if (!mem) return nullptr;
+            if (!_free && !add_slab(1)) return nullptr;
+            void* mem = _free;
+            _free = _free->next;
+            --_spare;
             return new (mem) node(static_cast<U&&>(v));
         }
 
@@ -668,10 +1213,147 @@ namespace io {
             return true;
         }
 
-        static void destroy_node(node* n) noexcept {
+        void destroy_node(node* n) noexcept {
             if (!n) return;
             n->~node();
-            ::operator delete(n);
+            _free = new (static_cast<void*>(n)) free_node{ _free };
+            ++_spare;
         }
     }; // struct list
+
+
+
+    // Links embedded in an object that lives on an intrusive_list.
+    // Unlinked hooks hold null pointers.
+    struct list_hook {
+        list_hook* prev{ nullptr };
+        list_hook* next{ nullptr };
+
+        IO_NODISCARD bool linked() const noexcept { return next != nullptr; }
+    };
+
+    // Doubly-linked list over objects that embed a list_hook at `Hook`.
+    // It never allocates and does not own the objects: they must outlive
+    // their membership, and clear() or the destructor only unlinks them.
+    // An object can be on as many lists as it has hooks.
+    template<typename T, list_hook T::*Hook>
+    struct intrusive_list {
+        using value_type = T;
+
+        struct iterator {
+            list_hook* h{ nullptr };
+
+            T& operator*() const noexcept { return *owner(h); }
+            T* operator->() const noexcept { return owner(h); }
+
+            iterator& operator++() noexcept { h = h->next; return *this; }
+            iterator operator++(int) noexcept { iterator t = *this; ++(*this); return t; }
+            iterator& operator--() noexcept { h = h->prev; return *this; }
+
+            friend bool operator==(iterator a, iterator b) noexcept { return a.h == b.h; }
+            friend bool operator!=(iterator a, iterator b) noexcept { return a.h != b.h; }
+        };
+
+        intrusive_list() noexcept { _root.prev = _root.next = &_root; }
+        ~intrusive_list() noexcept { clear(); }
+
+        intrusive_list(const intrusive_list&) = delete;
+        intrusive_list& operator=(const intrusive_list&) = delete;
+
+        intrusive_list(intrusive_list&& o) noexcept {
+            _root.prev = _root.next = &_root;
+            take(o);
+        }
+
+        intrusive_list& operator=(intrusive_list&& o) noexcept {
+            if (this == &o) return *this;
+            clear();
+            take(o);
+            return *this;
+        }
+
+        // ---- size ----
+        IO_NODISCARD usize size() const noexcept { return _len; }
+        IO_NODISCARD bool empty() const noexcept { return _len == 0; }
+
+        // ---- iterators ----
+        iterator begin() noexcept { return iterator{ _root.next }; }
+        iterator end() noexcept { return iterator{ &_root }; }
+
+        // ---- access ----
+        T& front() noexcept { return *owner(_root.next); }
+        T& back() noexcept { return *owner(_root.prev); }
+
+        // ---- modifiers ----
+        // `v` must not be linked through this hook already.
+        void push_back(T& v) noexcept { link_before(&_root, &(v.*Hook)); }
+        void push_front(T& v) noexcept { link_before(_root.next, &(v.*Hook)); }
+
+        // Links `v` before `pos`.
+        void insert(iterator pos, T& v) noexcept { link_before(pos.h, &(v.*Hook)); }
+
+        void pop_back() noexcept { if (_len) unlink(_root.prev); }
+        void pop_front() noexcept { if (_len) unlink(_root.next); }
+
+        // Unlinks `v`, which must be on this list; O(1).
+        void erase(T& v) noexcept { unlink(&(v.*Hook)); }
+
+        iterator erase(iterator it) noexcept {
+            list_hook* nx = it.h->next;
+            unlink(it.h);
+            return iterator{ nx };
+        }
+
+        void clear() noexcept {
+            list_hook* cur = _root.next;
+            while (cur != &_root) {
+                list_hook* nx = cur->next;
+                cur->prev = cur->next = nullptr;
+                cur = nx;
+            }
+            _root.prev = _root.next = &_root;
+            _len = 0;
+        }
+
+        // Recovers the object from its embedded hook.
+        static T* owner(list_hook* h) noexcept {
+            return reinterpret_cast<T*>(reinterpret_cast<char*>(h) - hook_offset());
+        }
+
+    private:
+        list_hook _root; // sentinel: next is the head, prev the tail
+        usize _len{ 0 };
+
+        static usize hook_offset() noexcept {
+            alignas(T) char probe[sizeof(T)];
+            const T* t = reinterpret_cast<const T*>(probe);
+            return static_cast<usize>(reinterpret_cast<const char*>(&(t->*Hook)) - probe);
+        }
+
+        void link_before(list_hook* at, list_hook* h) noexcept {
+            h->next = at;
+            h->prev = at->prev;
+            at->prev->next = h;
+            at->prev = h;
+            ++_len;
+        }
+
+        void unlink(list_hook* h) noexcept {
+            h->prev->next = h->next;
+            h->next->prev = h->prev;
+            h->prev = h->next = nullptr;
+            --_len;
+        }
+
+        void take(intrusive_list& o) noexcept {
+            if (o._len == 0) return;
+            _root.next = o._root.next;
+            _root.prev = o._root.prev;
+            _root.next->prev = &_root;
+            _root.prev->next = &_root;
+            _len = o._len;
+            o._root.prev = o._root.next = &o._root;
+            o._len = 0;
+        }
+    }; // struct intrusive_list
 } // namespace io
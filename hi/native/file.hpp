@@ -177,7 +177,7 @@ namespace io {
                 if (sz64 > (u64)static_cast<usize>(-1)) return false;
                 const usize sz = static_cast<usize>(sz64);
 
-                if (!out.resize(sz)) return false;
+                if (!out.resize_for_overwrite(sz)) return false; // read() fills it
 
                 usize got = 0;
                 while (got < sz) {
@@ -188,18 +188,20 @@ namespace io {
                 }
 
                 if (got < sz)
-                    if (!out.resize(got)) return false;
+                    if (!out.resize_for_overwrite(got)) return false;
                 return good() || eof();
             }
 
-            // 2) unknown size: chunked
-            char buf[4096];
-            io::view<char> chunk{ buf, sizeof(buf) };
+            // 2) unknown size: read straight into the string's spare capacity
+            usize got = 0;
             for (;;) {
+                if (!out.resize_for_overwrite(got + 4096)) return false;
+                io::view<char> chunk{ out.data() + got, out.capacity() - got };
                 usize r = read(chunk);
                 if (r == 0) break;
-                if (!out.append(io::char_view{ buf, r })) return false;
+                got += r;
             }
+            if (!out.resize_for_overwrite(got)) return false;
             return good() || eof();
         } // read_all
 
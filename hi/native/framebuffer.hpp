@@ -1,6 +1,7 @@
 #pragma once
 #include "types.hpp"
 #include "window.hpp"
+#include "syscalls.hpp" // io::PageFlags
 
 #ifdef __linux__
 // linux impl
@@ -14,6 +15,7 @@ namespace hi {
         // ------------------------- Native Framebuffer -----------------------
         struct Framebuffer {
         private:
+            io::PageFlags _page_flags{ io::PageFlags::None };
         #if defined(__linux__)
             // linux impl
         #elif defined(_WIN32)
@@ -38,6 +40,10 @@ namespace hi {
             void Clear(io::u32 rgba, int width, int height) const noexcept;
             void DrawPixel(int x, int y, int width, int height, io::u32 color) const noexcept;
         
+            // Applied to the pixel buffer on the next Recreate().
+            // The OS owns DIB memory, so only PageFlags::Prefault has an effect.
+            void setPageFlags(io::PageFlags flags) noexcept { _page_flags = flags; }
+
         #if defined(__linux__)
         
         #elif defined(_WIN32)
@@ -0,0 +1,327 @@
+#pragma once
+#include "types.hpp"
+#include "simd.hpp"
+
+namespace io {
+    namespace hash {
+
+        // ------------------------- Byte hashing -------------------------
+        // Fast 64-bit non-cryptographic hash (wyhash / XXH3 family) for
+        // tables, dedup and cache keys. Not for anything adversarial.
+        //
+        // Up to 16 bytes: two overlapping word loads and one 128-bit
+        // multiply-fold. Up to 128 bytes: a 16-byte multiply-fold chain.
+        // Longer inputs run XXH3-style accumulation: eight 64-bit lanes over
+        // 64-byte stripes, scrambled every 1 KiB; SSE2/AVX2 process two/four
+        // lanes per instruction. The scalar lanes compute the same values,
+        // so results do not depend on the SIMD level, and the constexpr
+        // path matches the run-time one.
+
+        namespace detail {
+            static IO_CONSTEXPR_VAR u64 P0 = 0xa0761d6478bd642full;
+            static IO_CONSTEXPR_VAR u64 P1 = 0xe7037ed1a0b428dbull;
+            static IO_CONSTEXPR_VAR u64 P2 = 0x8ebc6af09c88c6e3ull;
+            static IO_CONSTEXPR_VAR u64 P32 = 0x9e3779b1ull;
+
+            static IO_CONSTEXPR_VAR usize STRIPE = 64;
+            static IO_CONSTEXPR_VAR usize BLOCK_STRIPES = 16;
+            static IO_CONSTEXPR_VAR usize SCRAMBLE_KEY = 16; // SECRET[16..24)
+
+            // Stripe s of a block keys its lanes with SECRET[s .. s + 8).
+            static IO_CONSTEXPR_VAR u64 SECRET[24] = {
+                0x0bd2db2e48789d20ull, 0x7c621bc543b550a8ull, 0xb27410639e13de46ull, 0xd3c4eb1714b569e5ull,
+                0x9fc8be2266edda39ull, 0x491e4aceebe4be30ull, 0x180afb1a9570beb0ull, 0xca454537878d2950ull,
+                0xa96a98c828045478ull, 0xa4a4b920c8e15bf5ull, 0xae09d92fba683111ull, 0x1defe04876a32064ull,
+                0x1b830cede5f3a95full, 0x5d45a31f3dd3297full, 0x1b37fd03b9ada18eull, 0xa9cad3754033f149ull,
+                0x2bbe59b3c2df09d1ull, 0xc01f604b97fba984ull, 0xdad0325410c910f5ull, 0x0677e5dd8bdbadf9ull,
+                0x2bc9abfd44bc3b36ull, 0x08cf102312742cefull, 0x495cf4650c95833dull, 0x288961efe041bc37ull,
+            };
+
+            // Little-endian loads; `B` is char at compile time, u8 at run time.
+            template<typename B>
+            IO_NODISCARD IO_CONSTEXPR u64 r8(const B* p) noexcept {
+                u64 v = 0;
+                if (!IO_IS_CONSTANT_EVALUATED()) { IO_MEMCPY(&v, p, 8); return v; }
+                for (usize i = 8; i > 0; --i) v = (v << 8) | static_cast<u8>(p[i - 1]);
+                return v;
+            }
+
+            template<typename B>
+            IO_NODISCARD IO_CONSTEXPR u64 r4(const B* p) noexcept {
+                u32 v = 0;
+                if (!IO_IS_CONSTANT_EVALUATED()) { IO_MEMCPY(&v, p, 4); return v; }
+                for (usize i = 4; i > 0; --i) v = (v << 8) | static_cast<u8>(p[i - 1]);
+                return v;
+            }
+
+            // 64x64 -> 128 multiply; low half to `a`, high half to `b`.
+            IO_CONSTEXPR void mum(u64& a, u64& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+                const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+                a = static_cast<u64>(r);
+                b = static_cast<u64>(r >> 64);
+#else
+                const u64 ha = a >> 32, hb = b >> 32, la = static_cast<u32>(a), lb = static_cast<u32>(b);
+                const u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+                const u64 t = rl + (rm0 << 32);
+                u64 c = t < rl;
+                const u64 lo = t + (rm1 << 32);
+                c += lo < t;
+                a = lo;
+                b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+            }
+
+            IO_NODISCARD IO_CONSTEXPR u64 mix(u64 a, u64 b) noexcept {
+                mum(a, b);
+                return a ^ b;
+            }
+
+            IO_NODISCARD IO_CONSTEXPR u64 seed_mix(u64 seed) noexcept { return seed ^ mix(seed ^ P0, P1); }
+
+            IO_NODISCARD IO_CONSTEXPR u64 finalize(u64 a, u64 b, u64 seed, usize n) noexcept {
+                a ^= P1;
+                b ^= seed;
+                mum(a, b);
+                return mix(a ^ P0 ^ static_cast<u64>(n), b ^ P1);
+            }
+
+            // ---- long inputs: eight accumulator lanes ----
+            struct lanes {
+                u64 acc[8] = {
+                    0x00000000c2b2ae3dull, 0x9e3779b185ebca87ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull,
+                    0x85ebca77c2b2ae63ull, 0x0000000085ebca77ull, 0x27d4eb2f165667c5ull, 0x000000009e3779b1ull,
+                };
+                usize stripe{ 0 }; // position in the current block
+            };
+
+            // acc[i] += lo32(k) * hi32(k) + d[i ^ 1], with k = d[i] ^ key[i] + seed.
+            template<typename B>
+            IO_CONSTEXPR void stripe(u64* acc, const B* p, const u64* key, u64 seed) noexcept {
+                u64 d[8] = {};
+                for (usize i = 0; i < 8; ++i) d[i] = r8(p + 8 * i);
+                for (usize i = 0; i < 8; ++i) {
+                    const u64 k = d[i] ^ (key[i] + seed);
+                    acc[i] += (k & 0xffffffffull) * (k >> 32) + d[i ^ 1];
+                }
+            }
+
+            IO_CONSTEXPR void scramble(u64* acc) noexcept {
+                for (usize i = 0; i < 8; ++i) {
+                    u64 x = acc[i] ^ (acc[i] >> 47);
+                    x ^= SECRET[SCRAMBLE_KEY + i];
+                    acc[i] = x * P32;
+                }
+            }
+
+#ifdef IO_SIMD_SSE2
+#   ifdef IO_SIMD_AVX2
+            inline void accumulate_simd(lanes& l, const void* data, usize stripes, u64 seed) noexcept {
+                const u8* p = static_cast<const u8*>(data);
+                __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(l.acc));
+                __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(l.acc + 4));
+                const __m256i s = _mm256_set1_epi64x(static_cast<long long>(seed));
+                const __m256i prime = _mm256_set1_epi64x(static_cast<long long>(P32));
+
+                auto step = [&](__m256i acc, const u8* at, const u64* key) noexcept {
+                    const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at));
+                    const __m256i k = _mm256_xor_si256(d, _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(key)), s));
+                    const __m256i prod = _mm256_mul_epu32(k, _mm256_shuffle_epi32(k, 0x31));
+                    return _mm256_add_epi64(acc, _mm256_add_epi64(prod, _mm256_shuffle_epi32(d, 0x4e)));
+                };
+                auto scr = [&](__m256i acc, const u64* key) noexcept {
+                    __m256i x = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+                    x = _mm256_xor_si256(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key)));
+                    const __m256i lo = _mm256_mul_epu32(x, prime);
+                    const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), prime);
+                    return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+                };
+
+                for (; stripes; --stripes, p += STRIPE) {
+                    const u64* key = SECRET + l.stripe;
+                    a0 = step(a0, p, key);
+                    a1 = step(a1, p + 32, key + 4);
+                    if (++l.stripe == BLOCK_STRIPES) {
+                        a0 = scr(a0, SECRET + SCRAMBLE_KEY);
+                        a1 = scr(a1, SECRET + SCRAMBLE_KEY + 4);
+                        l.stripe = 0;
+                    }
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(l.acc), a0);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(l.acc + 4), a1);
+            }
+#   else
+            inline void accumulate_simd(lanes& l, const void* data, usize stripes, u64 seed) noexcept {
+                const u8* p = static_cast<const u8*>(data);
+                __m128i a[4];
+                for (usize v = 0; v < 4; ++v) a[v] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(l.acc + 2 * v));
+                const __m128i s = _mm_set1_epi64x(static_cast<long long>(seed));
+                const __m128i prime = _mm_set1_epi64x(static_cast<long long>(P32));
+
+                for (; stripes; --stripes, p += STRIPE) {
+                    const u64* key = SECRET + l.stripe;
+                    for (usize v = 0; v < 4; ++v) {
+                        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * v));
+                        const __m128i k = _mm_xor_si128(d, _mm_add_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(key + 2 * v)), s));
+                        const __m128i prod = _mm_mul_epu32(k, _mm_shuffle_epi32(k, 0x31));
+                        a[v] = _mm_add_epi64(a[v], _mm_add_epi64(prod, _mm_shuffle_epi32(d, 0x4e)));
+                    }
+                    if (++l.stripe == BLOCK_STRIPES) {
+                        for (usize v = 0; v < 4; ++v) {
+                            __m128i x = _mm_xor_si128(a[v], _mm_srli_epi64(a[v], 47));
+                            x = _mm_xor_si128(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(SECRET + SCRAMBLE_KEY + 2 * v)));
+                            const __m128i lo = _mm_mul_epu32(x, prime);
+                            const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(x, 32), prime);
+                            a[v] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+                        }
+                        l.stripe = 0;
+                    }
+                }
+                for (usize v = 0; v < 4; ++v) _mm_storeu_si128(reinterpret_cast<__m128i*>(l.acc + 2 * v), a[v]);
+            }
+#   endif
+#endif // IO_SIMD_SSE2
+
+            // Feeds `stripes` whole stripes, scrambling at block ends.
+            template<typename B>
+            IO_CONSTEXPR void accumulate(lanes& l, const B* p, usize stripes, u64 seed) noexcept {
+#ifdef IO_SIMD_SSE2
+                if (!IO_IS_CONSTANT_EVALUATED()) { accumulate_simd(l, p, stripes, seed); return; }
+#endif
+                for (; stripes; --stripes, p += STRIPE) {
+                    stripe(l.acc, p, SECRET + l.stripe, seed);
+                    if (++l.stripe == BLOCK_STRIPES) { scramble(l.acc); l.stripe = 0; }
+                }
+            }
+
+            // Folds the lanes after the last stripe, `last` = the final 64 bytes.
+            template<typename B>
+            IO_NODISCARD IO_CONSTEXPR u64 merge(lanes& l, const B* last, usize n, u64 seed) noexcept {
+                stripe(l.acc, last, SECRET + SCRAMBLE_KEY, seed);
+                u64 h = static_cast<u64>(n) * P2;
+                for (usize j = 0; j < 8; j += 2) h += mix(l.acc[j] ^ SECRET[j], l.acc[j + 1] ^ SECRET[j + 1]);
+                return mix(h ^ seed, P0);
+            }
+
+            template<typename B>
+            IO_NODISCARD IO_CONSTEXPR u64 bytes(const B* p, usize n, u64 seed) noexcept {
+                seed = seed_mix(seed);
+                u64 a = 0, b = 0;
+                if (n <= 16) {
+                    if (n >= 4) {
+                        const usize q = (n >> 3) << 2;
+                        a = (r4(p) << 32) | r4(p + q);
+                        b = (r4(p + n - 4) << 32) | r4(p + n - 4 - q);
+                    }
+                    else if (n) {
+                        a = (static_cast<u64>(static_cast<u8>(p[0])) << 16)
+                          | (static_cast<u64>(static_cast<u8>(p[n >> 1])) << 8)
+                          | static_cast<u8>(p[n - 1]);
+                    }
+                }
+                else {
+                    if (n > 128) {
+                        lanes l;
+                        accumulate(l, p, (n - 1) / STRIPE, seed);
+                        seed = merge(l, p + n - STRIPE, n, seed);
+                    }
+                    else {
+                        const B* q = p;
+                        for (usize i = n; i > 16; i -= 16, q += 16) seed = mix(r8(q) ^ P1, r8(q + 8) ^ seed);
+                    }
+                    a = r8(p + n - 16);
+                    b = r8(p + n - 8);
+                }
+                return finalize(a, b, seed, n);
+            }
+        } // namespace detail
+
+        // Hash of `n` bytes at `p`.
+        IO_NODISCARD inline u64 bytes(const void* p, usize n, u64 seed = 0) noexcept {
+            return detail::bytes(static_cast<const u8*>(p), n, seed);
+        }
+
+        IO_NODISCARD inline u64 of(byte_view v, u64 seed = 0) noexcept { return detail::bytes(v.data(), v.size(), seed); }
+
+        // Also usable in constant expressions, with the same result as at
+        // run time: `constexpr u64 k = io::hash::of(io::char_view("key"));`.
+        IO_NODISCARD IO_CONSTEXPR u64 of(char_view v, u64 seed = 0) noexcept { return detail::bytes(v.data(), v.size(), seed); }
+
+        // Finalizer for single integers (murmur3 fmix64).
+        IO_NODISCARD IO_CONSTEXPR u64 mix64(u64 x) noexcept {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdull;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ull;
+            x ^= x >> 33;
+            return x;
+        }
+
+        // ------------------------- Streaming -------------------------
+        // Incremental form: any split of the input into update() calls gives
+        // the same digest() as one bytes() call with the same seed.
+        struct stream {
+            explicit stream(u64 seed = 0) noexcept { reset(seed); }
+
+            void reset(u64 seed = 0) noexcept {
+                _seed = seed;
+                _lanes = detail::lanes{};
+                _total = 0;
+                _buffered = 0;
+            }
+
+            void update(const void* data, usize n) noexcept {
+                const u8* in = static_cast<const u8*>(data);
+                _total += n;
+                while (n) {
+                    if (_buffered == BUF) {
+                        // more input follows, so every buffered stripe but the
+                        // last (kept for digest) is final
+                        detail::accumulate(_lanes, _buf, BUF / detail::STRIPE - 1, detail::seed_mix(_seed));
+                        IO_MEMCPY(_buf, _buf + BUF - detail::STRIPE, detail::STRIPE);
+                        _buffered = detail::STRIPE;
+
+                        if (n > BUF) {
+                            // large update: stream straight from the input,
+                            // buffering only its final 65..128 bytes
+                            detail::accumulate(_lanes, _buf, 1, detail::seed_mix(_seed));
+                            const usize direct = (n - 1) / detail::STRIPE - 1;
+                            detail::accumulate(_lanes, in, direct, detail::seed_mix(_seed));
+                            in += direct * detail::STRIPE;
+                            n -= direct * detail::STRIPE;
+                            _buffered = 0;
+                        }
+                    }
+                    const usize k = n < BUF - _buffered ? n : BUF - _buffered;
+                    IO_MEMCPY(_buf + _buffered, in, k);
+                    _buffered += k;
+                    in += k;
+                    n -= k;
+                }
+            }
+            void update(byte_view v) noexcept { update(v.data(), v.size()); }
+            void update(char_view v) noexcept { update(v.data(), v.size()); }
+
+            IO_NODISCARD u64 digest() const noexcept {
+                // nothing has been consumed until more than BUF bytes arrived
+                if (_total <= 128) return detail::bytes(_buf, static_cast<usize>(_total), _seed);
+
+                const u64 seed = detail::seed_mix(_seed);
+                detail::lanes l = _lanes;
+                detail::accumulate(l, _buf, (_buffered - 1) / detail::STRIPE, seed);
+                const u64 folded = detail::merge(l, _buf + _buffered - detail::STRIPE, static_cast<usize>(_total), seed);
+                return detail::finalize(detail::r8(_buf + _buffered - 16), detail::r8(_buf + _buffered - 8),
+                    folded, static_cast<usize>(_total));
+            }
+
+        private:
+            static IO_CONSTEXPR_VAR usize BUF = 4 * detail::STRIPE;
+
+            detail::lanes _lanes;
+            u64 _seed{ 0 };
+            u64 _total{ 0 };
+            usize _buffered{ 0 }; // _buf starts on a stripe boundary of the input
+            u8 _buf[BUF];
+        }; // struct stream
+    } // namespace hash
+} // namespace io
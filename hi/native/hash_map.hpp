@@ -0,0 +1,471 @@
+#pragma once
+#include "types.hpp"
+#include "simd.hpp"
+#include "hash.hpp"
+#include "allocator.hpp"
+#include "containers.hpp" // basic_string keys, native::relocate
+
+namespace io {
+    // ------------------------- Key normalization -------------------------
+    // Strings and views of any constness hash and compare as view<const C>,
+    // so a table keyed by io::string is searched with a char_view or a
+    // literal without building a temporary string.
+    template<typename T>
+    IO_NODISCARD IO_CONSTEXPR const T& hash_key(const T& k) noexcept { return k; }
+
+    template<typename C>
+    IO_NODISCARD IO_CONSTEXPR view<const C> hash_key(const view<C>& v) noexcept { return view<const C>(v.data(), v.size()); }
+
+    template<typename C, typename A>
+    IO_NODISCARD inline view<const C> hash_key(const basic_string<C, A>& s) noexcept { return s.as_view(); }
+
+    template<usize N>
+    IO_NODISCARD IO_CONSTEXPR char_view hash_key(const char(&s)[N]) noexcept { return char_view(s); }
+
+    // Default Hash for hash_map / hash_set: integers, enums, pointers and
+    // character views/strings. Supply your own functor for other keys.
+    struct default_hash {
+        template<typename Q>
+        IO_NODISCARD u64 operator()(const Q& k) const noexcept { return of(hash_key(k)); }
+
+    private:
+        template<typename T, IO_REQUIRES_T(is_integral_v<T> || __is_enum(T))>
+        static u64 of(T x) noexcept { return hash::mix64(static_cast<u64>(x)); }
+
+        template<typename T>
+        static u64 of(T* p) noexcept { return hash::mix64(static_cast<u64>(reinterpret_cast<usize>(p))); }
+
+        template<typename C>
+        static u64 of(view<const C> v) noexcept { return hash::bytes(v.data(), v.size() * sizeof(C)); }
+    };
+
+    struct default_equal {
+        template<typename A, typename B>
+        IO_NODISCARD bool operator()(const A& a, const B& b) const noexcept { return hash_key(a) == hash_key(b); }
+    };
+
+    namespace native {
+        // ------------------------- Control bytes -------------------------
+        // One byte per slot: CTRL_EMPTY, or the low 7 hash bits of the key
+        // in a full slot. A group of them is matched at once.
+        static IO_CONSTEXPR_VAR u8 CTRL_EMPTY = 0x80;
+
+#ifdef IO_SIMD_SSE2
+        struct ctrl_group {
+            static IO_CONSTEXPR_VAR usize width = 16;
+            simd::u8x16 g;
+
+            static ctrl_group load(const u8* p) noexcept { return { simd::u8x16::load(p) }; }
+            // One bit per byte.
+            IO_NODISCARD u64 match(u8 tag) const noexcept { return g.eq(simd::u8x16::splat(tag)).mask(); }
+            IO_NODISCARD u64 match_empty() const noexcept { return g.mask(); }
+            static usize lowest(u64 m) noexcept { return simd::ctz(m); }
+        };
+#else
+        struct ctrl_group {
+            static IO_CONSTEXPR_VAR usize width = 8;
+            u64 w;
+
+            static ctrl_group load(const u8* p) noexcept { ctrl_group g; IO_MEMCPY(&g.w, p, 8); return g; }
+            // High bit of each byte; may flag extra bytes, which fail the key compare.
+            IO_NODISCARD u64 match(u8 tag) const noexcept { return simd::swar_zero_bytes(w ^ (simd::SWAR_LO * tag)); }
+            IO_NODISCARD u64 match_empty() const noexcept { return w & simd::SWAR_HI; }
+            static usize lowest(u64 m) noexcept { return simd::ctz(m) / 8; } // little-endian
+        };
+#endif
+
+        // ------------------------- flat_table -------------------------
+        // Open-addressing core shared by hash_map and hash_set. `S` is the
+        // slot type and has a `key` member.
+        //
+        // Slots are a power-of-two array probed linearly, a control group
+        // at a time: a lookup compares the 7-bit tags of a whole group with
+        // one vector compare and stops at the first group holding an empty
+        // slot. Erase shifts later entries of the run back into the hole
+        // instead of leaving a tombstone, so lookups never slow down with
+        // churn. The control array repeats its first group past the end so
+        // a group load at any slot needs no wrap-around.
+        template<typename S, typename Hash, typename Eq, typename Alloc>
+        struct flat_table : private Alloc {
+            static IO_CONSTEXPR_VAR usize NPOS = static_cast<usize>(-1);
+            static IO_CONSTEXPR_VAR usize MIN_CAPACITY = 16;
+
+            IO_CONSTEXPR flat_table() noexcept = default;
+            explicit flat_table(const Alloc& a) noexcept : Alloc(a) {}
+
+            ~flat_table() noexcept {
+                clear();
+                release();
+            }
+
+            flat_table(const flat_table&) = delete;
+            flat_table& operator=(const flat_table&) = delete;
+
+            flat_table(flat_table&& o) noexcept : Alloc(static_cast<Alloc&&>(o)) {
+                _slots = o._slots;  o._slots = nullptr;
+                _ctrl = o._ctrl;    o._ctrl = nullptr;
+                _cap = o._cap;      o._cap = 0;
+                _len = o._len;      o._len = 0;
+            }
+
+            flat_table& operator=(flat_table&& o) noexcept {
+                if (this == &o) return *this;
+                this->~flat_table();
+                new (this) flat_table(static_cast<flat_table&&>(o));
+                return *this;
+            }
+
+            IO_NODISCARD const Alloc& get_allocator() const noexcept { return *this; }
+
+            IO_NODISCARD usize size() const noexcept { return _len; }
+            IO_NODISCARD usize capacity() const noexcept { return _cap; }
+            IO_NODISCARD bool full(usize i) const noexcept { return _ctrl[i] != CTRL_EMPTY; }
+            IO_NODISCARD S& slot(usize i) const noexcept { return _slots[i]; }
+
+            // First full slot at or after `i`, or capacity().
+            IO_NODISCARD usize next_full(usize i) const noexcept {
+                while (i < _cap && !full(i)) ++i;
+                return i;
+            }
+
+            // Storage for `n` entries without rehashing.
+            IO_NODISCARD bool reserve(usize n) noexcept {
+                if (n * 8 <= _cap * 7) return true;
+                usize cap = MIN_CAPACITY;
+                while (n * 8 > cap * 7) cap *= 2;
+                return rehash(cap);
+            }
+
+            template<typename Q>
+            IO_NODISCARD usize find(const Q& q) const noexcept { return find_hashed(q, Hash{}(q)); }
+
+            // Index of the entry for `q`; otherwise claims an empty slot for
+            // it (`inserted` is set and the caller constructs the slot).
+            // NPOS if the table could not grow.
+            template<typename Q>
+            IO_NODISCARD usize find_or_claim(const Q& q, bool& inserted) noexcept {
+                inserted = false;
+                const u64 h = Hash{}(q);
+                const usize at = find_hashed(q, h);
+                if (at != NPOS) return at;
+                if ((_len + 1) * 8 > _cap * 7 && !rehash(_cap ? _cap * 2 : MIN_CAPACITY)) return NPOS;
+
+                const usize i = find_empty(h);
+                set_ctrl(i, h2(h));
+                ++_len;
+                inserted = true;
+                return i;
+            }
+
+            // Destroys the entry at `i` and closes the gap.
+            void erase_at(usize i) noexcept {
+                _slots[i].~S();
+                const usize m = mask();
+                usize hole = i;
+                for (usize j = (i + 1) & m; full(j); j = (j + 1) & m) {
+                    const usize home = h1(Hash{}(_slots[j].key)) & m;
+                    if (((j - home) & m) >= ((j - hole) & m)) { // hole lies in [home, j)
+                        native::relocate(_slots + hole, _slots + j, 1);
+                        set_ctrl(hole, _ctrl[j]);
+                        hole = j;
+                    }
+                }
+                set_ctrl(hole, CTRL_EMPTY);
+                --_len;
+            }
+
+            // Destroys every entry; the storage is kept.
+            void clear() noexcept {
+                if (!_cap) return;
+                if (!is_trivially_destructible_v<S>)
+                    for (usize i = 0; i < _cap; ++i)
+                        if (full(i)) _slots[i].~S();
+                IO_MEMSET(_ctrl, CTRL_EMPTY, _cap + ctrl_group::width);
+                _len = 0;
+            }
+
+        private:
+            S* _slots{ nullptr }; // _cap slots, then the control bytes
+            u8* _ctrl{ nullptr }; // _cap + ctrl_group::width bytes
+            usize _cap{ 0 };      // power of two, or 0
+            usize _len{ 0 };
+
+            Alloc& alloc() noexcept { return *this; }
+
+            static u8 h2(u64 h) noexcept { return static_cast<u8>(h & 0x7f); }
+            static usize h1(u64 h) noexcept { return static_cast<usize>(h >> 7); }
+            static usize storage_bytes(usize cap) noexcept { return cap * sizeof(S) + cap + ctrl_group::width; }
+
+            IO_NODISCARD usize mask() const noexcept { return _cap - 1; }
+
+            void set_ctrl(usize i, u8 c) noexcept {
+                _ctrl[i] = c;
+                if (i < ctrl_group::width) _ctrl[_cap + i] = c; // mirror
+            }
+
+            template<typename Q>
+            IO_NODISCARD usize find_hashed(const Q& q, u64 h) const noexcept {
+                if (!_cap) return NPOS;
+                const u8 tag = h2(h);
+                usize pos = h1(h) & mask();
+                for (;;) {
+                    const ctrl_group g = ctrl_group::load(_ctrl + pos);
+                    const u64 e = g.match_empty();
+                    u64 m = g.match(tag);
+                    if (e) m &= (e & (0 - e)) - 1; // nothing lives past an empty slot
+                    for (; m; m &= m - 1) {
+                        const usize i = (pos + ctrl_group::lowest(m)) & mask();
+                        if (Eq{}(_slots[i].key, q)) return i;
+                    }
+                    if (e) return NPOS;
+                    pos = (pos + ctrl_group::width) & mask();
+                }
+            }
+
+            IO_NODISCARD usize find_empty(u64 h) const noexcept {
+                usize pos = h1(h) & mask();
+                for (;;) {
+                    const u64 e = ctrl_group::load(_ctrl + pos).match_empty();
+                    if (e) return (pos + ctrl_group::lowest(e)) & mask();
+                    pos = (pos + ctrl_group::width) & mask();
+                }
+            }
+
+            IO_NODISCARD bool rehash(usize cap) noexcept {
+                void* mem = alloc().allocate(storage_bytes(cap), alignof(S));
+                if (!mem) return false;
+
+                S* old_slots = _slots;
+                u8* old_ctrl = _ctrl;
+                const usize old_cap = _cap;
+
+                _slots = static_cast<S*>(mem);
+                _ctrl = reinterpret_cast<u8*>(_slots + cap);
+                _cap = cap;
+                IO_MEMSET(_ctrl, CTRL_EMPTY, cap + ctrl_group::width);
+
+                for (usize i = 0; i < old_cap; ++i) {
+                    if (old_ctrl[i] == CTRL_EMPTY) continue;
+                    const u64 h = Hash{}(old_slots[i].key);
+                    const usize j = find_empty(h);
+                    set_ctrl(j, h2(h));
+                    native::relocate(_slots + j, old_slots + i, 1);
+                }
+                if (old_slots) alloc().deallocate(old_slots, storage_bytes(old_cap), alignof(S));
+                return true;
+            }
+
+            void release() noexcept {
+                if (_slots) alloc().deallocate(_slots, storage_bytes(_cap), alignof(S));
+                _slots = nullptr;
+                _ctrl = nullptr;
+                _cap = 0;
+            }
+        }; // struct flat_table
+
+        template<typename Table, typename S, typename R>
+        struct table_iterator {
+            const Table* t{ nullptr };
+            usize i{ 0 };
+
+            R& operator*() const noexcept { return get(t->slot(i)); }
+            R* operator->() const noexcept { return &get(t->slot(i)); }
+
+            table_iterator& operator++() noexcept { i = t->next_full(i + 1); return *this; }
+            table_iterator operator++(int) noexcept { table_iterator c = *this; ++(*this); return c; }
+
+            friend bool operator==(table_iterator a, table_iterator b) noexcept { return a.i == b.i; }
+            friend bool operator!=(table_iterator a, table_iterator b) noexcept { return a.i != b.i; }
+
+        private:
+            static R& get(S& s) noexcept { return select(s, constant<bool, is_same_v<S, R> || is_same_v<const S, R>>{}); }
+            static R& select(S& s, true_t) noexcept { return s; }
+            static R& select(S& s, false_t) noexcept { return s.key; }
+        };
+    } // namespace native
+
+    // ------------------------------ hash_map ------------------------------
+    // Open-addressing map with SIMD group probing (see native::flat_table).
+    // Move-only; operations report allocation failure instead of throwing.
+    // Lookups take any key type Hash and Eq accept, so a
+    // hash_map<io::string, V> is searched with a char_view.
+    // Entries move on rehash and erase: pointers to them are valid until
+    // the next insertion or erase. Do not modify `key` through iteration.
+    template<typename K, typename V, typename Hash = default_hash, typename Eq = default_equal,
+        typename Alloc = heap_allocator>
+    struct hash_map {
+        struct entry {
+            K key;
+            V value;
+        };
+
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = entry;
+        using allocator_type = Alloc;
+
+    private:
+        using table_t = native::flat_table<entry, Hash, Eq, Alloc>;
+
+    public:
+        using iterator = native::table_iterator<table_t, entry, entry>;
+        using const_iterator = native::table_iterator<table_t, entry, const entry>;
+
+        IO_CONSTEXPR hash_map() noexcept = default;
+        explicit hash_map(const Alloc& a) noexcept : _t(a) {}
+
+        hash_map(const hash_map&) = delete;
+        hash_map& operator=(const hash_map&) = delete;
+        hash_map(hash_map&&) noexcept = default;
+        hash_map& operator=(hash_map&&) noexcept = default;
+
+        IO_NODISCARD const Alloc& get_allocator() const noexcept { return _t.get_allocator(); }
+
+        // ---- size/capacity ----
+        IO_NODISCARD usize size() const noexcept { return _t.size(); }
+        IO_NODISCARD bool empty() const noexcept { return _t.size() == 0; }
+        IO_NODISCARD usize capacity() const noexcept { return _t.capacity(); }
+
+        // Makes room for `n` entries without rehashing.
+        IO_NODISCARD bool reserve(usize n) noexcept { return _t.reserve(n); }
+
+        // ---- iterators ----
+        iterator begin() noexcept { return iterator{ &_t, _t.next_full(0) }; }
+        iterator end() noexcept { return iterator{ &_t, _t.capacity() }; }
+        const_iterator begin() const noexcept { return const_iterator{ &_t, _t.next_full(0) }; }
+        const_iterator end() const noexcept { return const_iterator{ &_t, _t.capacity() }; }
+
+        // ---- lookup ----
+        template<typename Q>
+        IO_NODISCARD V* find(const Q& key) noexcept {
+            const usize i = _t.find(key);
+            return i == table_t::NPOS ? nullptr : &_t.slot(i).value;
+        }
+        template<typename Q>
+        IO_NODISCARD const V* find(const Q& key) const noexcept {
+            const usize i = _t.find(key);
+            return i == table_t::NPOS ? nullptr : &_t.slot(i).value;
+        }
+        template<typename Q>
+        IO_NODISCARD bool contains(const Q& key) const noexcept { return _t.find(key) != table_t::NPOS; }
+
+        // ---- modifiers ----
+        // Value for `key`, constructing K(key) and V(args...) if it is new.
+        // nullptr if the table could not grow.
+        template<typename Q, typename... Args>
+        IO_NODISCARD V* try_emplace(Q&& key, Args&&... args) noexcept {
+            bool inserted;
+            const usize i = _t.find_or_claim(key, inserted);
+            if (i == table_t::NPOS) return nullptr;
+            entry& e = _t.slot(i);
+            if (inserted) {
+                new (&e.key) K(static_cast<Q&&>(key));
+                new (&e.value) V(static_cast<Args&&>(args)...);
+            }
+            return &e.value;
+        }
+
+        // Sets the value for `key`, inserting it if new.
+        template<typename Q, typename U>
+        IO_NODISCARD V* insert_or_assign(Q&& key, U&& value) noexcept {
+            bool inserted;
+            const usize i = _t.find_or_claim(key, inserted);
+            if (i == table_t::NPOS) return nullptr;
+            entry& e = _t.slot(i);
+            if (inserted) {
+                new (&e.key) K(static_cast<Q&&>(key));
+                new (&e.value) V(static_cast<U&&>(value));
+            }
+            else {
+                e.value = static_cast<U&&>(value);
+            }
+            return &e.value;
+        }
+
+        // Returns whether `key` was present.
+        template<typename Q>
+        bool erase(const Q& key) noexcept {
+            const usize i = _t.find(key);
+            if (i == table_t::NPOS) return false;
+            _t.erase_at(i);
+            return true;
+        }
+
+        void clear() noexcept { _t.clear(); }
+
+    private:
+        table_t _t;
+    }; // struct hash_map
+
+    // ------------------------------ hash_set ------------------------------
+    // Set counterpart of hash_map, with the same probing and lifetime rules.
+    template<typename K, typename Hash = default_hash, typename Eq = default_equal,
+        typename Alloc = heap_allocator>
+    struct hash_set {
+        struct entry {
+            K key;
+        };
+
+        using key_type = K;
+        using value_type = K;
+        using allocator_type = Alloc;
+
+    private:
+        using table_t = native::flat_table<entry, Hash, Eq, Alloc>;
+
+    public:
+        using iterator = native::table_iterator<table_t, entry, const K>;
+        using const_iterator = iterator;
+
+        IO_CONSTEXPR hash_set() noexcept = default;
+        explicit hash_set(const Alloc& a) noexcept : _t(a) {}
+
+        hash_set(const hash_set&) = delete;
+        hash_set& operator=(const hash_set&) = delete;
+        hash_set(hash_set&&) noexcept = default;
+        hash_set& operator=(hash_set&&) noexcept = default;
+
+        IO_NODISCARD const Alloc& get_allocator() const noexcept { return _t.get_allocator(); }
+
+        IO_NODISCARD usize size() const noexcept { return _t.size(); }
+        IO_NODISCARD bool empty() const noexcept { return _t.size() == 0; }
+        IO_NODISCARD usize capacity() const noexcept { return _t.capacity(); }
+        IO_NODISCARD bool reserve(usize n) noexcept { return _t.reserve(n); }
+
+        iterator begin() const noexcept { return iterator{ &_t, _t.next_full(0) }; }
+        iterator end() const noexcept { return iterator{ &_t, _t.capacity() }; }
+
+        template<typename Q>
+        IO_NODISCARD const K* find(const Q& key) const noexcept {
+            const usize i = _t.find(key);
+            return i == table_t::NPOS ? nullptr : &_t.slot(i).key;
+        }
+        template<typename Q>
+        IO_NODISCARD bool contains(const Q& key) const noexcept { return _t.find(key) != table_t::NPOS; }
+
+        // The stored key equal to `key`, inserting K(key) if new; nullptr if
+        // the table could not grow.
+        template<typename Q>
+        IO_NODISCARD const K* insert(Q&& key) noexcept {
+            bool inserted;
+            const usize i = _t.find_or_claim(key, inserted);
+            if (i == table_t::NPOS) return nullptr;
+            entry& e = _t.slot(i);
+            if (inserted) new (&e.key) K(static_cast<Q&&>(key));
+            return &e.key;
+        }
+
+        template<typename Q>
+        bool erase(const Q& key) noexcept {
+            const usize i = _t.find(key);
+            if (i == table_t::NPOS) return false;
+            _t.erase_at(i);
+            return true;
+        }
+
+        void clear() noexcept { _t.clear(); }
+
+    private:
+        table_t _t;
+    }; // struct hash_set
+} // namespace io
@@ -0,0 +1,205 @@
+#pragma once
+#include "types.hpp"
+#include "simd.hpp"
+
+namespace io {
+    namespace mem {
+
+        // ------------------------- Memory primitives -------------------------
+        // memcpy / memmove / memset / memcmp without a C runtime. These back
+        // the CRT-free build's own memcpy & co. (hi/source.cpp) and the
+        // containers' bulk paths.
+        //
+        // Sizes up to 16 (32/64 with SSE2/AVX2) are a single branch on the
+        // size class and two overlapping loads/stores from each end; nothing
+        // loops. Larger blocks run a vector loop (a u64 word without SIMD)
+        // with the first and last block loaded up front and stored at the end,
+        // so there is no scalar tail, and the loop's stores are aligned.
+        //
+        // Fixed-size IO_MEMCPY below compiles to a single mov; it never calls
+        // back into memcpy.
+
+        namespace detail {
+            template<typename T>
+            IO_NODISCARD inline T load(const u8* p) noexcept { T v; IO_MEMCPY(&v, p, sizeof(T)); return v; }
+
+            template<typename T>
+            inline void store(u8* p, T v) noexcept { IO_MEMCPY(p, &v, sizeof(T)); }
+
+            // Portable 16-byte block for the paths below.
+            struct u8x16w {
+                static IO_CONSTEXPR_VAR usize width = 16;
+                u64 lo, hi;
+
+                static u8x16w load(const void* p) noexcept {
+                    const u8* b = static_cast<const u8*>(p);
+                    return { detail::load<u64>(b), detail::load<u64>(b + 8) };
+                }
+                static u8x16w splat(u8 c) noexcept { return { simd::SWAR_LO * c, simd::SWAR_LO * c }; }
+                void store(void* p) const noexcept {
+                    u8* b = static_cast<u8*>(p);
+                    detail::store(b, lo);
+                    detail::store(b + 8, hi);
+                }
+            };
+
+#ifdef IO_SIMD_SSE2
+            using V16 = simd::u8x16;
+#else
+            using V16 = u8x16w;
+#endif
+#ifdef IO_SIMD_AVX2
+            using V32 = simd::u8x32;
+#endif
+
+            // [0, 16]: every load happens before any store, so the source
+            // and destination may overlap.
+            inline void copy_small(u8* d, const u8* s, usize n) noexcept {
+                if (n >= 8) {
+                    const u64 a = load<u64>(s), b = load<u64>(s + n - 8);
+                    store(d, a); store(d + n - 8, b);
+                }
+                else if (n >= 4) {
+                    const u32 a = load<u32>(s), b = load<u32>(s + n - 4);
+                    store(d, a); store(d + n - 4, b);
+                }
+                else if (n >= 2) {
+                    const u16 a = load<u16>(s), b = load<u16>(s + n - 2);
+                    store(d, a); store(d + n - 2, b);
+                }
+                else if (n) {
+                    *d = *s;
+                }
+            }
+
+            // [W, 2W] with two overlapping blocks; overlap-safe as well.
+            template<typename V>
+            inline void copy_two(u8* d, const u8* s, usize n) noexcept {
+                const V a = V::load(s), b = V::load(s + n - V::width);
+                a.store(d);
+                b.store(d + n - V::width);
+            }
+
+            // n >= W. Safe for overlap when d <= s: each load is ahead of
+            // everything stored so far.
+            template<typename V>
+            inline void copy_forward(u8* d, const u8* s, usize n) noexcept {
+                const usize W = V::width;
+                const V head = V::load(s), tail = V::load(s + n - W);
+                usize i = W - (reinterpret_cast<usize>(d) & (W - 1)); // first aligned store
+                for (; i + W < n; i += W) V::load(s + i).store(d + i);
+                head.store(d);
+                tail.store(d + n - W);
+            }
+
+            // n >= W. Safe for overlap when d >= s: walks from the end.
+            template<typename V>
+            inline void copy_backward(u8* d, const u8* s, usize n) noexcept {
+                const usize W = V::width;
+                const V head = V::load(s), tail = V::load(s + n - W);
+                usize i = n - ((reinterpret_cast<usize>(d) + n) & (W - 1)); // last aligned end
+                while (i > W) {
+                    i -= W;
+                    V::load(s + i).store(d + i);
+                }
+                head.store(d);
+                tail.store(d + n - W);
+            }
+
+            template<typename V>
+            inline void fill(u8* d, u8 c, usize n) noexcept {
+                const usize W = V::width;
+                const V v = V::splat(c);
+                usize i = W - (reinterpret_cast<usize>(d) & (W - 1));
+                for (; i + W < n; i += W) v.store(d + i);
+                v.store(d);
+                v.store(d + n - W);
+            }
+
+            // Copies of up to the size-class limit; false if `n` is bulk.
+            inline bool copy_sized(u8* d, const u8* s, usize n) noexcept {
+                if (n <= 16) { copy_small(d, s, n); return true; }
+                if (n <= 32) { copy_two<V16>(d, s, n); return true; }
+#ifdef IO_SIMD_AVX2
+                if (n <= 64) { copy_two<V32>(d, s, n); return true; }
+#endif
+                return false;
+            }
+
+#ifdef IO_SIMD_AVX2
+            using VLoop = simd::u8x32;
+#else
+            using VLoop = V16;
+#endif
+        } // namespace detail
+
+        // memcpy: [dst, dst + n) and [src, src + n) must not overlap.
+        inline void* copy(void* dst, const void* src, usize n) noexcept {
+            u8* d = static_cast<u8*>(dst);
+            const u8* s = static_cast<const u8*>(src);
+            if (!detail::copy_sized(d, s, n)) detail::copy_forward<detail::VLoop>(d, s, n);
+            return dst;
+        }
+
+        // memmove: the ranges may overlap.
+        inline void* move(void* dst, const void* src, usize n) noexcept {
+            u8* d = static_cast<u8*>(dst);
+            const u8* s = static_cast<const u8*>(src);
+            if (detail::copy_sized(d, s, n) || d == s) return dst;
+            // forward unless the destination starts inside the source
+            if (reinterpret_cast<usize>(d) - reinterpret_cast<usize>(s) >= n)
+                detail::copy_forward<detail::VLoop>(d, s, n);
+            else
+                detail::copy_backward<detail::VLoop>(d, s, n);
+            return dst;
+        }
+
+        // memset
+        inline void* set(void* dst, int ch, usize n) noexcept {
+            u8* d = static_cast<u8*>(dst);
+            const u8 c = static_cast<u8>(ch);
+            if (n >= 16) {
+#ifdef IO_SIMD_AVX2
+                if (n >= 32) { detail::fill<simd::u8x32>(d, c, n); return dst; }
+#endif
+                detail::fill<detail::V16>(d, c, n);
+                return dst;
+            }
+            const u64 w = simd::SWAR_LO * c;
+            if (n >= 8)      { detail::store(d, w); detail::store(d + n - 8, w); }
+            else if (n >= 4) { detail::store(d, static_cast<u32>(w)); detail::store(d + n - 4, static_cast<u32>(w)); }
+            else if (n >= 2) { detail::store(d, static_cast<u16>(w)); detail::store(d + n - 2, static_cast<u16>(w)); }
+            else if (n)      { *d = c; }
+            return dst;
+        }
+
+        // memcmp: <0, 0 or >0 by the first differing byte, compared unsigned.
+        IO_NODISCARD inline int compare(const void* lhs, const void* rhs, usize n) noexcept {
+            const u8* a = static_cast<const u8*>(lhs);
+            const u8* b = static_cast<const u8*>(rhs);
+            usize i = 0;
+#ifdef IO_SIMD_SSE2
+            using V = simd::u8xN;
+            static IO_CONSTEXPR_VAR u32 ALL = static_cast<u32>((u64(1) << V::width) - 1);
+            if (n >= V::width) {
+                for (; i + V::width <= n; i += V::width) {
+                    const u32 m = V::load(a + i).eq(V::load(b + i)).mask() ^ ALL;
+                    if (m) { i += simd::ctz(m); return int(a[i]) - int(b[i]); }
+                }
+                if (i == n) return 0;
+                i = n - V::width;
+                const u32 m = V::load(a + i).eq(V::load(b + i)).mask() ^ ALL;
+                if (m) { i += simd::ctz(m); return int(a[i]) - int(b[i]); }
+                return 0;
+            }
+#endif
+            for (; i + 8 <= n; i += 8) {
+                const u64 x = detail::load<u64>(a + i) ^ detail::load<u64>(b + i);
+                if (x) { i += simd::ctz(x) / 8; return int(a[i]) - int(b[i]); } // little-endian
+            }
+            for (; i < n; ++i)
+                if (a[i] != b[i]) return int(a[i]) - int(b[i]);
+            return 0;
+        }
+    } // namespace mem
+} // namespace io
@@ -73,6 +73,7 @@ namespace io {
             inline const Out& operator<<(io::char_view v) const noexcept;
             inline const Out& operator<<(const ::io::string& v) const noexcept;
             inline const Out& operator<<(const ::io::wstring& w) const noexcept;
+            inline const Out& operator<<(const AllocStats& s) const noexcept; // one line per used class
             
             // --- manipulators ---
             inline const Out& operator<<(const Out& (*manip)(const Out&)) const noexcept;
@@ -108,7 +108,7 @@ namespace native {
 
 
 
-    inline void Out::reset() noexcept { global::out_buffer[0] = '\0'; global::out_buffer_count = 0; }
+    inline void Out::reset() noexcept { ::io::global::out_buffer[0] = '\0'; ::io::global::out_buffer_count = 0; }
  
     inline void Out::write(const char* msg, usize len) noexcept {
 #ifndef IO_TERMINAL
@@ -125,7 +125,7 @@ namespace native {
 #ifndef IO_TERMINAL
         return;
 #else
-        using namespace global;
+        using namespace ::io::global;
         if (out_buffer_count == 0) {
             // Keep the invariant: zero-terminated buffer
             out_buffer[0] = '\0';
@@ -138,7 +138,7 @@ namespace native {
     }
 
     inline io::char_view Out::scrap_view() const noexcept {
-        using namespace global;
+        using namespace ::io::global;
         // Ensure NUL-termination
         if (out_buffer_count >= IO_TERMINAL_BUFFER_SIZE)
             out_buffer_count = IO_TERMINAL_BUFFER_SIZE - 1;
@@ -150,7 +150,7 @@ namespace native {
 #ifndef IO_TERMINAL
         (void)c;
 #else
-        using namespace global;
+        using namespace ::io::global;
         if (out_buffer_count < IO_TERMINAL_BUFFER_SIZE - 1)
             out_buffer[out_buffer_count++] = c;
         else {
@@ -164,7 +164,7 @@ namespace native {
 #ifndef IO_TERMINAL
         (void)str; (void)count;
 #else
-        using namespace global;
+        using namespace ::io::global;
         while (count-- && out_buffer_count < IO_TERMINAL_BUFFER_SIZE - 1)
             out_buffer[out_buffer_count++] = *str++;
 #endif
@@ -174,7 +174,7 @@ namespace native {
 #ifndef IO_TERMINAL
         (void)str;
 #else
-        using namespace global;
+        using namespace ::io::global;
         while (*str && out_buffer_count < IO_TERMINAL_BUFFER_SIZE - 1)
             out_buffer[out_buffer_count++] = *str++;
 #endif
@@ -261,6 +261,24 @@ namespace native {
     // --- complex types ---
     inline const Out& Out::operator<<(io::char_view v) const noexcept { write(v.data(), v.size()); return *this; }
     inline const Out& Out::operator<<(const ::io::string& v) const noexcept { return *this << v.as_view(); }
+    inline const Out& Out::operator<<(const AllocStats& s) const noexcept {
+        if (!AllocStats::enabled) return *this << "alloc stats: compiled out (define IO_ALLOC_STATS)" << endl;
+
+        auto row = [this](const char* name, usize block_size, const AllocStats::Class& c) noexcept {
+            *this << name;
+            if (block_size) *this << static_cast<u64>(block_size) << " B";
+            *this << ": allocs=" << c.allocs << " frees=" << c.frees
+                  << " live=" << c.live_bytes << " peak=" << c.peak_bytes
+                  << " refills=" << c.refills << " syscalls=" << c.syscalls << endl;
+        };
+        for (usize idx = 0; idx < STAT_CLASSES; ++idx) {
+            const AllocStats::Class& c = s.classes[idx];
+            if (!c.allocs && !c.syscalls) continue;
+            row(c.block_size ? "" : "large", c.block_size, c);
+        }
+        row("total", 0, s.total);
+        return *this;
+    }
     inline const Out& Out::operator<<(const ::io::wstring& w) const noexcept {
 #ifndef IO_TERMINAL
         (void)w; return *this;
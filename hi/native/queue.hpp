@@ -0,0 +1,347 @@
+#pragma once
+#include "types.hpp"
+#include "atomic.hpp"
+#include "allocator.hpp"
+#include "syscalls.hpp"   // futex_wait / futex_wake_one
+#include "containers.hpp" // native::copy_init / relocate
+
+namespace io {
+
+    // ------------------------- spsc_ring -------------------------
+    // Bounded lock-free queue between exactly one producer thread and one
+    // consumer thread. Capacity is a power of two, so a position is a mask
+    // of a free-running counter.
+    //
+    // The producer owns `_tail`, the consumer `_head`, each on its own
+    // cache line together with a cached copy of the other side's index:
+    // a push reads `_head` (a cross-core miss) only when the cached value
+    // says the ring is full, a pop reads `_tail` only when it looks empty.
+    // push_n / pop_n move a whole batch with one index publish.
+    //
+    // init() allocates the ring before it is shared; the ring itself is
+    // neither copyable nor movable.
+    template<typename T, typename Alloc = heap_allocator>
+    struct spsc_ring : private Alloc {
+        using value_type = T;
+        using allocator_type = Alloc;
+
+        spsc_ring() noexcept = default;
+        explicit spsc_ring(const Alloc& a) noexcept : Alloc(a) {}
+
+        ~spsc_ring() noexcept {
+            const usize h = _head.load(memory_order_relaxed);
+            const usize t = _tail.load(memory_order_relaxed);
+            for (usize i = h; i != t; ++i) _buf[i & _mask].~T();
+            if (_buf) alloc().deallocate(_buf, capacity() * sizeof(T), alignof(T));
+        }
+
+        spsc_ring(const spsc_ring&) = delete;
+        spsc_ring& operator=(const spsc_ring&) = delete;
+
+        // Allocates room for at least `min_capacity` elements (rounded up to
+        // a power of two). Call once, before either thread uses the ring.
+        IO_NODISCARD bool init(usize min_capacity) noexcept {
+            if (_buf) return false;
+            usize cap = 1;
+            while (cap < min_capacity) cap <<= 1;
+            _buf = static_cast<T*>(alloc().allocate(cap * sizeof(T), alignof(T)));
+            if (!_buf) return false;
+            _mask = cap - 1;
+            return true;
+        }
+
+        IO_NODISCARD usize capacity() const noexcept { return _buf ? _mask + 1 : 0; }
+
+        // Exact only when both threads are idle.
+        IO_NODISCARD usize size_approx() const noexcept {
+            return _tail.load(memory_order_acquire) - _head.load(memory_order_acquire);
+        }
+
+        // ---- producer ----
+        IO_NODISCARD bool try_push(const T& v) noexcept {
+            const usize t = _tail.load(memory_order_relaxed);
+            if (!room(t, 1)) return false;
+            new (_buf + (t & _mask)) T(v);
+            _tail.store(t + 1, memory_order_release);
+            return true;
+        }
+
+        IO_NODISCARD bool try_push(T&& v) noexcept {
+            const usize t = _tail.load(memory_order_relaxed);
+            if (!room(t, 1)) return false;
+            new (_buf + (t & _mask)) T(io::move(v));
+            _tail.store(t + 1, memory_order_release);
+            return true;
+        }
+
+        // Copies up to `n` elements from `src`; returns how many fit.
+        IO_NODISCARD usize push_n(const T* src, usize n) noexcept {
+            const usize t = _tail.load(memory_order_relaxed);
+            const usize free = room(t, n);
+            if (n > free) n = free;
+            if (!n) return 0;
+
+            const usize at = t & _mask;
+            const usize first = n < capacity() - at ? n : capacity() - at;
+            native::copy_init(_buf + at, src, first);
+            native::copy_init(_buf, src + first, n - first);
+            _tail.store(t + n, memory_order_release);
+            return n;
+        }
+        IO_NODISCARD usize push_n(view<const T> src) noexcept { return push_n(src.data(), src.size()); }
+
+        // ---- consumer ----
+        IO_NODISCARD bool try_pop(T& out) noexcept {
+            const usize h = _head.load(memory_order_relaxed);
+            if (!ready(h, 1)) return false;
+            T* p = _buf + (h & _mask);
+            out = io::move(*p);
+            p->~T();
+            _head.store(h + 1, memory_order_release);
+            return true;
+        }
+
+        // Moves up to `n` elements into uninitialized `out`, in order;
+        // returns how many.
+        IO_NODISCARD usize pop_n(T* out, usize n) noexcept {
+            const usize h = _head.load(memory_order_relaxed);
+            const usize avail = ready(h, n);
+            if (n > avail) n = avail;
+            if (!n) return 0;
+
+            const usize at = h & _mask;
+            const usize first = n < capacity() - at ? n : capacity() - at;
+            native::relocate(out, _buf + at, first);
+            native::relocate(out + first, _buf, n - first);
+            _head.store(h + n, memory_order_release);
+            return n;
+        }
+
+    private:
+        // Read-only after init(), shared by both sides.
+        alignas(IO_CACHE_LINE) T* _buf{ nullptr };
+        usize _mask{ 0 };
+
+        // Producer line.
+        alignas(IO_CACHE_LINE) atomic<usize> _tail{ 0 };
+        usize _head_cache{ 0 };
+
+        // Consumer line.
+        alignas(IO_CACHE_LINE) atomic<usize> _head{ 0 };
+        usize _tail_cache{ 0 };
+
+        Alloc& alloc() noexcept { return *this; }
+
+        // Free slots for the producer at tail `t`, refreshing the cached
+        // head only if fewer than `want` look free.
+        usize room(usize t, usize want) noexcept {
+            usize free = capacity() - (t - _head_cache);
+            if (free < want) {
+                _head_cache = _head.load(memory_order_acquire);
+                free = capacity() - (t - _head_cache);
+            }
+            return free;
+        }
+
+        // Filled slots for the consumer at head `h`, likewise.
+        usize ready(usize h, usize want) noexcept {
+            usize avail = _tail_cache - h;
+            if (avail < want) {
+                _tail_cache = _tail.load(memory_order_acquire);
+                avail = _tail_cache - h;
+            }
+            return avail;
+        }
+    }; // struct spsc_ring
+
+    // ------------------------- mpmc_queue -------------------------
+    // Bounded lock-free queue for any number of producers and consumers
+    // (Vyukov). Every slot carries a sequence number that says whose turn
+    // it is: `pos` when free for the producer claiming position `pos`,
+    // `pos + 1` once filled for the consumer at `pos`. A thread claims a
+    // position with one CAS on the enqueue / dequeue counter, which sit on
+    // separate cache lines, and then touches only its own slot - there is
+    // no shared lock and no contention between the two sides.
+    //
+    // push / pop block: a thread that finds the queue full (empty) parks on
+    // a futex word that the other side bumps only while someone is parked,
+    // so the uncontended path never makes a syscall.
+    //
+    // init() allocates the slots before the queue is shared; the queue
+    // itself is neither copyable nor movable.
+    template<typename T, typename Alloc = heap_allocator>
+    struct mpmc_queue : private Alloc {
+        using value_type = T;
+        using allocator_type = Alloc;
+
+        mpmc_queue() noexcept = default;
+        explicit mpmc_queue(const Alloc& a) noexcept : Alloc(a) {}
+
+        ~mpmc_queue() noexcept {
+            if (!_cells) return;
+            const usize t = _enqueue.load(memory_order_relaxed);
+            for (usize i = _dequeue.load(memory_order_relaxed); i != t; ++i)
+                _cells[i & _mask].value()->~T();
+            alloc().deallocate(_cells, capacity() * sizeof(cell), alignof(cell));
+        }
+
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        // Allocates at least `min_capacity` slots (rounded up to a power of
+        // two, minimum 2). Call once, before any thread uses the queue.
+        IO_NODISCARD bool init(usize min_capacity) noexcept {
+            if (_cells) return false;
+            usize cap = 2;
+            while (cap < min_capacity) cap <<= 1;
+            _cells = static_cast<cell*>(alloc().allocate(cap * sizeof(cell), alignof(cell)));
+            if (!_cells) return false;
+            for (usize i = 0; i < cap; ++i) new (&_cells[i].seq) atomic<usize>(i);
+            _mask = cap - 1;
+            return true;
+        }
+
+        IO_NODISCARD usize capacity() const noexcept { return _cells ? _mask + 1 : 0; }
+
+        // Exact only when no thread is pushing or popping.
+        IO_NODISCARD usize size_approx() const noexcept {
+            const usize h = _dequeue.load(memory_order_acquire);
+            const usize n = _enqueue.load(memory_order_acquire) - h;
+            return n < capacity() ? n : capacity();
+        }
+
+        // ---- non-blocking ----
+        // `v` is left untouched when the queue is full.
+        IO_NODISCARD bool try_push(const T& v) noexcept {
+            usize pos;
+            cell* c = claim_push(pos);
+            if (!c) return false;
+            new (c->storage) T(v);
+            c->seq.store(pos + 1, memory_order_release);
+            signal(_items, _consumers_parked);
+            return true;
+        }
+
+        IO_NODISCARD bool try_push(T&& v) noexcept {
+            usize pos;
+            cell* c = claim_push(pos);
+            if (!c) return false;
+            new (c->storage) T(io::move(v));
+            c->seq.store(pos + 1, memory_order_release);
+            signal(_items, _consumers_parked);
+            return true;
+        }
+
+        IO_NODISCARD bool try_pop(T& out) noexcept {
+            usize pos;
+            cell* c = claim_pop(pos);
+            if (!c) return false;
+            T* p = c->value();
+            out = io::move(*p);
+            p->~T();
+            c->seq.store(pos + _mask + 1, memory_order_release);
+            signal(_space, _producers_parked);
+            return true;
+        }
+
+        // ---- blocking ----
+        void push(const T& v) noexcept {
+            while (!try_push(v))
+                if (park(_space, _producers_parked, [&] { return try_push(v); })) return;
+        }
+
+        void push(T&& v) noexcept {
+            while (!try_push(io::move(v)))
+                if (park(_space, _producers_parked, [&] { return try_push(io::move(v)); })) return;
+        }
+
+        void pop(T& out) noexcept {
+            while (!try_pop(out))
+                if (park(_items, _consumers_parked, [&] { return try_pop(out); })) return;
+        }
+
+    private:
+        struct cell {
+            atomic<usize> seq;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* value() noexcept { return reinterpret_cast<T*>(storage); }
+        };
+
+        static_assert(sizeof(atomic<u32>) == sizeof(u32), "futex word must be a plain u32");
+
+        // Read-only after init(), shared by everyone.
+        alignas(IO_CACHE_LINE) cell* _cells{ nullptr };
+        usize _mask{ 0 };
+
+        // Producer / consumer claim counters, one line each.
+        alignas(IO_CACHE_LINE) atomic<usize> _enqueue{ 0 };
+        alignas(IO_CACHE_LINE) atomic<usize> _dequeue{ 0 };
+
+        // Parking: `_items` is bumped after a push while consumers are
+        // parked, `_space` after a pop while producers are. Written only on
+        // the slow path, so the fast path merely reads the counts.
+        alignas(IO_CACHE_LINE) atomic<u32> _items{ 0 };
+        atomic<u32> _consumers_parked{ 0 };
+        alignas(IO_CACHE_LINE) atomic<u32> _space{ 0 };
+        atomic<u32> _producers_parked{ 0 };
+
+        Alloc& alloc() noexcept { return *this; }
+
+        // Claims the slot at the enqueue position, or nullptr when full.
+        cell* claim_push(usize& pos) noexcept {
+            if (!_cells) return nullptr;
+            pos = _enqueue.load(memory_order_relaxed);
+            for (;;) {
+                cell* c = &_cells[pos & _mask];
+                const isize dif = static_cast<isize>(c->seq.load(memory_order_acquire) - pos);
+                if (dif == 0) {
+                    if (_enqueue.compare_exchange_strong(pos, pos + 1,
+                            memory_order_relaxed, memory_order_relaxed)) return c;
+                }
+                else if (dif < 0) return nullptr; // a full lap behind: full
+                else pos = _enqueue.load(memory_order_relaxed);
+            }
+        }
+
+        // Claims the filled slot at the dequeue position, or nullptr when empty.
+        cell* claim_pop(usize& pos) noexcept {
+            if (!_cells) return nullptr;
+            pos = _dequeue.load(memory_order_relaxed);
+            for (;;) {
+                cell* c = &_cells[pos & _mask];
+                const isize dif = static_cast<isize>(c->seq.load(memory_order_acquire) - (pos + 1));
+                if (dif == 0) {
+                    if (_dequeue.compare_exchange_strong(pos, pos + 1,
+                            memory_order_relaxed, memory_order_relaxed)) return c;
+                }
+                else if (dif < 0) return nullptr; // not filled yet: empty
+                else pos = _dequeue.load(memory_order_relaxed);
+            }
+        }
+
+        // The seq_cst fence orders the slot publish before the parked
+        // count read, pairing with the fence after the increment in park():
+        // either we see the parked thread, or its retry sees our slot.
+        static void signal(atomic<u32>& word, atomic<u32>& parked) noexcept {
+            io::atomic_thread_fence(memory_order_seq_cst);
+            if (parked.load(memory_order_relaxed) == 0) return;
+            (void)word.fetch_add(1, memory_order_release);
+            futex_wake_one(reinterpret_cast<const u32*>(&word));
+        }
+
+        // One attempt to sleep until `word` moves. Re-runs `attempt` after
+        // registering as parked and snapshotting the word, so a signal
+        // between the failed try and the wait is never lost.
+        template<typename F>
+        static bool park(atomic<u32>& word, atomic<u32>& parked, F&& attempt) noexcept {
+            (void)parked.fetch_add(1, memory_order_seq_cst);
+            io::atomic_thread_fence(memory_order_seq_cst); // pairs with the fence in signal()
+            const u32 seen = word.load(memory_order_acquire);
+            const bool done = attempt();
+            if (!done) futex_wait(reinterpret_cast<const u32*>(&word), seen);
+            (void)parked.fetch_sub(1, memory_order_relaxed);
+            return done;
+        }
+    }; // struct mpmc_queue
+} // namespace io
@@ -0,0 +1,115 @@
+#pragma once
+#include "types.hpp"
+#include "simd.hpp"
+
+namespace io {
+    namespace native {
+
+        // ------------------------- Byte search ------------------------------
+        // Kernels behind view<byte>::find / find_first_of. Each returns the
+        // offset of the first match in [p, p + n), or `NOT_FOUND`.
+        // Vector paths finish with one overlapping load over the last full
+        // block instead of a scalar tail.
+
+        static IO_CONSTEXPR_VAR usize NOT_FOUND = static_cast<usize>(-1);
+
+        IO_NODISCARD inline bool equal_bytes(const u8* a, const u8* b, usize n) noexcept {
+            for (usize i = 0; i < n; ++i) if (a[i] != b[i]) return false;
+            return true;
+        }
+
+        // memchr
+        IO_NODISCARD inline usize find_byte(const u8* p, usize n, u8 b) noexcept {
+            usize i = 0;
+#ifdef IO_SIMD_SSE2
+            using V = simd::u8xN;
+            if (n >= V::width) {
+                const V needle = V::splat(b);
+                for (; i + V::width <= n; i += V::width) {
+                    const u32 m = V::load(p + i).eq(needle).mask();
+                    if (m) return i + simd::ctz(m);
+                }
+                if (i == n) return NOT_FOUND;
+                const u32 m = V::load(p + n - V::width).eq(needle).mask();
+                return m ? n - V::width + simd::ctz(m) : NOT_FOUND;
+            }
+#else
+            const u64 pattern = simd::SWAR_LO * b;
+            for (; i + 8 <= n; i += 8) {
+                u64 w;
+                IO_MEMCPY(&w, p + i, 8);
+                const u64 z = simd::swar_zero_bytes(w ^ pattern);
+                if (z) return i + simd::ctz(z) / 8; // little-endian: lowest byte first
+            }
+#endif
+            for (; i < n; ++i) if (p[i] == b) return i;
+            return NOT_FOUND;
+        }
+
+        // First byte that is any of set[0..set_n): multi-delimiter scanning.
+        IO_NODISCARD inline usize find_any_byte(const u8* p, usize n, const u8* set, usize set_n) noexcept {
+            if (set_n == 0) return NOT_FOUND;
+            if (set_n == 1) return find_byte(p, n, set[0]);
+
+            usize i = 0;
+#ifdef IO_SIMD_SSE2
+            using V = simd::u8xN;
+            if (set_n <= 16 && n >= V::width) {
+                V needles[16];
+                for (usize k = 0; k < set_n; ++k) needles[k] = V::splat(set[k]);
+
+                auto scan = [&](usize at) noexcept -> u32 {
+                    const V x = V::load(p + at);
+                    V hit = x.eq(needles[0]);
+                    for (usize k = 1; k < set_n; ++k) hit = hit | x.eq(needles[k]);
+                    return hit.mask();
+                };
+                for (; i + V::width <= n; i += V::width)
+                    if (const u32 m = scan(i)) return i + simd::ctz(m);
+                if (i == n) return NOT_FOUND;
+                const u32 m = scan(n - V::width);
+                return m ? n - V::width + simd::ctz(m) : NOT_FOUND;
+            }
+#endif
+            bool in_set[256] = {};
+            for (usize k = 0; k < set_n; ++k) in_set[set[k]] = true;
+            for (; i < n; ++i) if (in_set[p[i]]) return i;
+            return NOT_FOUND;
+        }
+
+        // Substring search. SIMD-filtered: a position is only compared in
+        // full when both the needle's first and last byte match there, which
+        // rejects almost every candidate 16/32 positions at a time.
+        IO_NODISCARD inline usize find_bytes(const u8* hay, usize n, const u8* needle, usize m) noexcept {
+            if (m == 0) return 0;
+            if (m > n) return NOT_FOUND;
+            if (m == 1) return find_byte(hay, n, needle[0]);
+
+            const u8 first = needle[0];
+            const u8 last = needle[m - 1];
+            usize i = 0;
+#ifdef IO_SIMD_SSE2
+            using V = simd::u8xN;
+            const V vfirst = V::splat(first);
+            const V vlast = V::splat(last);
+            for (; i + m - 1 + V::width <= n; i += V::width) {
+                u32 mask = (V::load(hay + i).eq(vfirst) & V::load(hay + i + m - 1).eq(vlast)).mask();
+                while (mask) {
+                    const usize at = i + simd::ctz(mask);
+                    if (equal_bytes(hay + at + 1, needle + 1, m - 2)) return at;
+                    mask &= mask - 1;
+                }
+            }
+#endif
+            // jump between occurrences of the first byte
+            while (i + m <= n) {
+                const usize at = find_byte(hay + i, n - m + 1 - i, first);
+                if (at == NOT_FOUND) return NOT_FOUND;
+                i += at;
+                if (hay[i + m - 1] == last && equal_bytes(hay + i + 1, needle + 1, m - 2)) return i;
+                ++i;
+            }
+            return NOT_FOUND;
+        }
+    } // namespace native
+} // namespace io
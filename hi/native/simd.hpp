@@ -0,0 +1,98 @@
+#pragma once
+#include "types.hpp"
+
+// -------------------- SIMD level ---------------------------------------------
+// Picked at compile time from the target flags: AVX2 with -mavx2 or
+// /arch:AVX2, SSE2 on any x86-64 (and x86 with /arch:SSE2 or -msse2),
+// scalar/SWAR everywhere else. Define `IO_NO_SIMD` to force the portable paths.
+#if !defined(IO_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define IO_SIMD_SSE2
+#   include <emmintrin.h>
+#endif
+#if defined(IO_SIMD_SSE2) && defined(__AVX2__)
+#   define IO_SIMD_AVX2
+#   include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#   include <intrin.h> // _BitScanForward
+#endif
+
+namespace io {
+    namespace simd {
+
+        // ---------------------- Bit helpers -------------------------------
+        // Index of the lowest set bit; `x` must not be zero.
+        IO_NODISCARD inline u32 ctz(u32 x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long i;
+            _BitScanForward(&i, x);
+            return static_cast<u32>(i);
+#else
+            return static_cast<u32>(__builtin_ctz(x));
+#endif
+        }
+
+        IO_NODISCARD inline u32 ctz(u64 x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+            unsigned long i;
+            _BitScanForward64(&i, x);
+            return static_cast<u32>(i);
+#elif defined(_MSC_VER) && !defined(__clang__)
+            const u32 lo = static_cast<u32>(x);
+            return lo ? ctz(lo) : 32 + ctz(static_cast<u32>(x >> 32));
+#else
+            return static_cast<u32>(__builtin_ctzll(x));
+#endif
+        }
+
+        // ---------------------- SWAR (8 bytes per word) ---------------------
+        static IO_CONSTEXPR_VAR u64 SWAR_LO = 0x0101010101010101ull;
+        static IO_CONSTEXPR_VAR u64 SWAR_HI = 0x8080808080808080ull;
+
+        // High bit set in every zero byte of `w`; the lowest flag is exact
+        // (higher ones may be false positives after a borrow).
+        IO_NODISCARD IO_CONSTEXPR u64 swar_zero_bytes(u64 w) noexcept {
+            return (w - SWAR_LO) & ~w & SWAR_HI;
+        }
+
+        // ---------------------- Byte vectors --------------------------------
+        // Thin wrappers so byte kernels are written once for any width:
+        // unaligned load/store, splat, per-byte compare, bitwise ops and a
+        // movemask with one bit per byte.
+#ifdef IO_SIMD_SSE2
+        struct u8x16 {
+            static IO_CONSTEXPR_VAR usize width = 16;
+            __m128i v;
+
+            static u8x16 load(const void* p) noexcept { return { _mm_loadu_si128(static_cast<const __m128i*>(p)) }; }
+            static u8x16 splat(u8 b) noexcept { return { _mm_set1_epi8(static_cast<char>(b)) }; }
+            void store(void* p) const noexcept { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+
+            u8x16 eq(u8x16 o) const noexcept { return { _mm_cmpeq_epi8(v, o.v) }; }
+            u8x16 operator&(u8x16 o) const noexcept { return { _mm_and_si128(v, o.v) }; }
+            u8x16 operator|(u8x16 o) const noexcept { return { _mm_or_si128(v, o.v) }; }
+            IO_NODISCARD u32 mask() const noexcept { return static_cast<u32>(_mm_movemask_epi8(v)); }
+        };
+#endif // IO_SIMD_SSE2
+
+#ifdef IO_SIMD_AVX2
+        struct u8x32 {
+            static IO_CONSTEXPR_VAR usize width = 32;
+            __m256i v;
+
+            static u8x32 load(const void* p) noexcept { return { _mm256_loadu_si256(static_cast<const __m256i*>(p)) }; }
+            static u8x32 splat(u8 b) noexcept { return { _mm256_set1_epi8(static_cast<char>(b)) }; }
+            void store(void* p) const noexcept { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+
+            u8x32 eq(u8x32 o) const noexcept { return { _mm256_cmpeq_epi8(v, o.v) }; }
+            u8x32 operator&(u8x32 o) const noexcept { return { _mm256_and_si256(v, o.v) }; }
+            u8x32 operator|(u8x32 o) const noexcept { return { _mm256_or_si256(v, o.v) }; }
+            IO_NODISCARD u32 mask() const noexcept { return static_cast<u32>(_mm256_movemask_epi8(v)); }
+        };
+
+        using u8xN = u8x32; // widest available
+#elif defined(IO_SIMD_SSE2)
+        using u8xN = u8x16;
+#endif
+    } // namespace simd
+} // namespace io
@@ -2,112 +2,1077 @@
 #include "types.hpp"
 #include "syscalls.hpp"
 #include "atomic.hpp"
+#include "mem.hpp"
 
 #include <cstddef> // std::max_align_t
 
+// -------------------- Chunk granularity ------------------------------------
+// Slabs are mapped aligned to, and in multiples of, one chunk, so the chunk
+// map can tell the size class of any pooled pointer from its address alone.
+// 64 KiB matches the Windows allocation granularity.
+#ifndef IO_ALLOC_CHUNK_SHIFT
+#   define IO_ALLOC_CHUNK_SHIFT 16
+#endif
+
+// -------------------- Slab sizes (per size class) ---------------------------
+// When a pool runs dry it maps one slab and carves slots off its front on
+// demand, instead of paying one `io::alloc` per block; pages nobody has been
+// handed yet are never touched, so they cost no RSS. Override per class if needed,
+// e.g. `IO_SLOT_SLAB_BYTES_32` = 2 MiB to back the 32-byte pool by a huge page.
+// Must be a multiple of the chunk size.
+#ifndef IO_SLOT_SLAB_BYTES
+#   define IO_SLOT_SLAB_BYTES (64u * 1024u)
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_8
+#   define IO_SLOT_SLAB_BYTES_8 IO_SLOT_SLAB_BYTES
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_16
+#   define IO_SLOT_SLAB_BYTES_16 IO_SLOT_SLAB_BYTES
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_32
+#   define IO_SLOT_SLAB_BYTES_32 IO_SLOT_SLAB_BYTES
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_64
+#   define IO_SLOT_SLAB_BYTES_64 IO_SLOT_SLAB_BYTES
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_128
+#   define IO_SLOT_SLAB_BYTES_128 IO_SLOT_SLAB_BYTES
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_256
+#   define IO_SLOT_SLAB_BYTES_256 IO_SLOT_SLAB_BYTES
+#endif
+// medium classes: each slot is itself a run of pages from a larger slab
+#ifndef IO_SLOT_SLAB_BYTES_512
+#   define IO_SLOT_SLAB_BYTES_512 IO_SLOT_SLAB_BYTES
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_1024
+#   define IO_SLOT_SLAB_BYTES_1024 IO_SLOT_SLAB_BYTES
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_2048
+#   define IO_SLOT_SLAB_BYTES_2048 (128u * 1024u)
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_4096
+#   define IO_SLOT_SLAB_BYTES_4096 (256u * 1024u)
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_8192
+#   define IO_SLOT_SLAB_BYTES_8192 (256u * 1024u)
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_16384
+#   define IO_SLOT_SLAB_BYTES_16384 (512u * 1024u)
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_32768
+#   define IO_SLOT_SLAB_BYTES_32768 (1024u * 1024u)
+#endif
+#ifndef IO_SLOT_SLAB_BYTES_65536
+#   define IO_SLOT_SLAB_BYTES_65536 (1024u * 1024u)
+#endif
+
+// -------------------- Statistics -------------------------------------------
+// Define `IO_ALLOC_STATS` to count allocations, frees, live and peak bytes,
+// thread cache refills and page syscalls per size class (relaxed atomics on
+// every allocate/deallocate). Without it every hook is an empty inline and
+// `io::native::alloc_stats()` returns zeros.
+
+// -------------------- Thread caches (magazines) ----------------------------
+// Every thread keeps a bounded private free list per size class and trades
+// whole batches with the shared pools, so the common path touches no atomics.
+// A thread's magazines are flushed back to the pools when it exits.
+// They live in `thread_local` storage, or with `IO_THREAD_CACHE_KEYED` in a
+// block found through a thread key (FLS / pthread key), which needs no CRT:
+// CRT-free Windows builds (`IO_NOSTD`) get that by default, as the CRT is
+// what provides `thread_local` there. `IO_NO_THREAD_CACHE` turns them off.
+// A magazine holds at most IO_MAGAZINE_SLOTS slots and at most
+// IO_MAGAZINE_BYTES bytes (but never fewer than 2 slots) and trades half of
+// that per exchange.
+#ifndef IO_MAGAZINE_SLOTS
+#   define IO_MAGAZINE_SLOTS 64u
+#endif
+#ifndef IO_MAGAZINE_BYTES
+#   define IO_MAGAZINE_BYTES (256u * 1024u)
+#endif
+#if defined(IO_NOSTD) && defined(_WIN32) && !defined(IO_THREAD_CACHE_KEYED)
+#   define IO_THREAD_CACHE_KEYED
+#endif
+
+// -------------------- Misuse -----------------------------------------------
+// A pointer the allocator never handed out (or already gave back to the OS)
+// stops debug builds; release builds drop it rather than let it into a pool.
+#ifdef _DEBUG
+#   if defined(_MSC_VER) && !defined(__clang__)
+#       define IO_ALLOC_MISUSE() __debugbreak()
+#   else
+#       define IO_ALLOC_MISUSE() __builtin_trap()
+#   endif
+#else
+#   define IO_ALLOC_MISUSE() ((void)0)
+#endif
+
 
 namespace io {
     namespace native {
 
         static constexpr usize DEFAULT_ALIGNMENT = alignof(std::max_align_t);
 
-        struct BlockHeader {
-            usize size;  // total bytes including header
-        };
-        static_assert(alignof(BlockHeader) >= DEFAULT_ALIGNMENT, "header align");
-        static_assert(sizeof(BlockHeader) % DEFAULT_ALIGNMENT == 0, "payload alignment");
-
+        // `next` of a slot that has been on a shared stack may be read by a
+        // stale pop in another thread at any time, so links are written with
+        // relaxed atomic stores (a plain move) and read by pops likewise.
         struct FreeNode {
             FreeNode* next;
+
+            IO_NODISCARD FreeNode* load_next() const noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+                return __atomic_load_n(&next, __ATOMIC_RELAXED);
+#else
+                return *static_cast<FreeNode* const volatile*>(&next); // aligned word: single access
+#endif
+            }
+            void store_next(FreeNode* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+                __atomic_store_n(&next, p, __ATOMIC_RELAXED);
+#else
+                *static_cast<FreeNode* volatile*>(&next) = p;
+#endif
+            }
         };
 
+        // ------------------------- Tagged Stack ------------------------------
+        // Lock-free LIFO of FreeNodes (Treiber stack) whose head carries a
+        // generation tag next to the pointer, so a pop that read `node->next`
+        // before another thread popped `node`, reused it and pushed it back
+        // fails its CAS instead of installing a stale `next` (ABA).
+        //
+        // 64-bit: nodes are pointer-aligned user-space addresses below
+        // 2^IO_TAGGED_ADDRESS_BITS, so the pointer is packed shifted right by its
+        // alignment and the freed high bits hold the tag (19 bits with the
+        // default 48). 32-bit: pointer and tag get a half of the u64 each.
+        // Slots are never unmapped while they may be reachable from a stack,
+        // so the speculative `node->next` read is memory safe; it is a relaxed
+        // atomic load racing only with relaxed stores (see FreeNode).
+#ifndef IO_TAGGED_ADDRESS_BITS
+#   define IO_TAGGED_ADDRESS_BITS 48
+#endif
+        struct TaggedStack {
+            static IO_CONSTEXPR_VAR usize ALIGN_SHIFT = 3;
+            static IO_CONSTEXPR_VAR u64 TAG_BITS = sizeof(void*) == 8
+                ? 64 - (IO_TAGGED_ADDRESS_BITS - ALIGN_SHIFT)
+                : 32;
+            static IO_CONSTEXPR_VAR u64 TAG_MASK = (u64(1) << TAG_BITS) - 1;
+            static_assert(sizeof(void*) != 8 || alignof(FreeNode) >= (usize(1) << ALIGN_SHIFT), "tag packing relies on node alignment");
+
+            atomic<u64> head{ 0 };
+
+            IO_CONSTEXPR TaggedStack() noexcept = default;
+
+            IO_NODISCARD static u64 pack(FreeNode* p, u64 tag) noexcept {
+                const u64 bits = sizeof(void*) == 8
+                    ? static_cast<u64>(reinterpret_cast<usize>(p)) >> ALIGN_SHIFT
+                    : static_cast<u64>(reinterpret_cast<usize>(p));
+                return (bits << TAG_BITS) | (tag & TAG_MASK);
+            }
+            IO_NODISCARD static FreeNode* ptr(u64 v) noexcept {
+                const u64 bits = v >> TAG_BITS;
+                return reinterpret_cast<FreeNode*>(static_cast<usize>(
+                    sizeof(void*) == 8 ? bits << ALIGN_SHIFT : bits));
+            }
+            IO_NODISCARD static u64 tag(u64 v) noexcept { return v & TAG_MASK; }
+
+            IO_NODISCARD bool empty() const noexcept { return ptr(head.load(memory_order_acquire)) == nullptr; }
+
+            IO_NODISCARD FreeNode* pop() noexcept {
+                u64 old = head.load(memory_order_acquire);
+                for (;;) {
+                    FreeNode* node = ptr(old);
+                    if (!node) return nullptr;
+                    const u64 desired = pack(node->load_next(), tag(old) + 1);
+                    if (head.compare_exchange_strong(old, desired, memory_order_acq_rel, memory_order_acquire))
+                        return node;
+                }
+            } // pop
+
+            // Splice an already linked chain [first..last] on top with one CAS.
+            void push(FreeNode* first, FreeNode* last) noexcept {
+                u64 old = head.load(memory_order_acquire);
+                for (;;) {
+                    last->store_next(ptr(old));
+                    const u64 desired = pack(first, tag(old) + 1);
+                    if (head.compare_exchange_strong(old, desired, memory_order_acq_rel, memory_order_acquire))
+                        return;
+                }
+            } // push
+
+            // Detach the whole stack; returns its first node (chain ends in nullptr).
+            IO_NODISCARD FreeNode* take_all() noexcept {
+                u64 old = head.load(memory_order_acquire);
+                while (!head.compare_exchange_strong(old, pack(nullptr, tag(old) + 1), memory_order_acq_rel, memory_order_acquire)) {}
+                return ptr(old);
+            } // take_all
+        }; // struct TaggedStack
+
+        // ------------------------- Chunk Map ---------------------------------
+        // Two-level radix table: chunk index (address >> IO_ALLOC_CHUNK_SHIFT) ->
+        // u32 tag, 0 meaning "not ours". Leaves (64K entries) are mapped lazily
+        // and never released; untouched root entries cost address space only.
+        //
+        // Tag: slot size of the owning slab, or LARGE | chunk count for a block
+        // that has its own mapping.
+        struct ChunkMap {
+            static IO_CONSTEXPR_VAR u32 LARGE = 0x80000000u;
+
+            static IO_CONSTEXPR_VAR usize CHUNK_SHIFT = IO_ALLOC_CHUNK_SHIFT;
+            static IO_CONSTEXPR_VAR usize CHUNK_BYTES = usize(1) << CHUNK_SHIFT;
+            static IO_CONSTEXPR_VAR usize ADDRESS_BITS = sizeof(void*) == 8 ? IO_TAGGED_ADDRESS_BITS : 32;
+            static IO_CONSTEXPR_VAR usize INDEX_BITS = ADDRESS_BITS - CHUNK_SHIFT;
+            static IO_CONSTEXPR_VAR usize LEAF_BITS = INDEX_BITS < 16 ? INDEX_BITS : 16;
+            static IO_CONSTEXPR_VAR usize LEAF_SIZE = usize(1) << LEAF_BITS;
+            static IO_CONSTEXPR_VAR usize ROOT_SIZE = usize(1) << (INDEX_BITS - LEAF_BITS);
+
+            atomic<u32*> root[ROOT_SIZE];
+
+            IO_NODISCARD u32 get(const void* p) const noexcept {
+                const usize i = reinterpret_cast<usize>(p) >> CHUNK_SHIFT;
+                if ((i >> LEAF_BITS) >= ROOT_SIZE) return 0;
+                const u32* leaf = root[i >> LEAF_BITS].load(memory_order_acquire);
+                return leaf ? leaf[i & (LEAF_SIZE - 1)] : 0;
+            }
+
+            // Tag every chunk of [base, base + bytes); both are chunk multiples.
+            IO_NODISCARD bool set(const void* base, usize bytes, u32 value) noexcept {
+                const usize first = reinterpret_cast<usize>(base) >> CHUNK_SHIFT;
+                const usize last = first + (bytes >> CHUNK_SHIFT);
+                for (usize i = first; i < last; ++i) {
+                    u32* leaf = leaf_for(i);
+                    if (!leaf) return false;
+                    leaf[i & (LEAF_SIZE - 1)] = value;
+                }
+                return true;
+            }
+
+        private:
+            IO_NODISCARD u32* leaf_for(usize i) noexcept {
+                if ((i >> LEAF_BITS) >= ROOT_SIZE) return nullptr;
+                atomic<u32*>& slot = root[i >> LEAF_BITS];
+                u32* leaf = slot.load(memory_order_acquire);
+                if (leaf) return leaf;
+
+                // pages come zeroed; lose the race -> drop ours, use theirs
+                u32* fresh = static_cast<u32*>(io::map_pages(LEAF_SIZE * sizeof(u32)));
+                if (!fresh) return nullptr;
+                if (slot.compare_exchange_strong(leaf, fresh, memory_order_acq_rel, memory_order_acquire))
+                    return fresh;
+                io::unmap_pages(fresh, LEAF_SIZE * sizeof(u32));
+                return leaf;
+            }
+        }; // struct ChunkMap
+
+        namespace global {
+            extern ChunkMap chunk_map; // defined in source.cpp
+        } // namespace global
+
+        // ------------------------- Spin Lock ---------------------------------
+        // Guards slow paths only (slab bookkeeping), never the slot fast path.
+        struct SpinLock {
+            atomic<u32> flag{ 0 };
+
+            IO_CONSTEXPR SpinLock() noexcept = default;
+
+            void lock() noexcept {
+                while (flag.exchange(1, memory_order_acquire)) {
+                    while (flag.load(memory_order_relaxed)) io::sleep_ms(0);
+                }
+            }
+            void unlock() noexcept { flag.store(0, memory_order_release); }
+        }; // struct SpinLock
+
+        // ------------------------- Slab Registry -----------------------------
+        // Address-sorted list of the slabs one pool has mapped, stored in pages
+        // of its own. Lets trim() attribute free slots to slabs and find the
+        // slabs whose pages were handed back. Caller holds the pool's lock.
+        struct SlabRegistry {
+            struct Slab {
+                u8* base;
+                u32 free;      // scratch counter for trim()
+                u32 discarded; // pages returned to the OS, slots not linked anywhere
+            };
+
+            Slab* slabs{ nullptr };
+            usize count{ 0 };
+            usize capacity{ 0 };
+
+            IO_CONSTEXPR SlabRegistry() noexcept = default;
+
+            IO_NODISCARD bool insert(u8* base) noexcept {
+                if (count == capacity && !grow()) return false;
+                usize i = count;
+                for (; i > 0 && slabs[i - 1].base > base; --i) slabs[i] = slabs[i - 1];
+                slabs[i] = Slab{ base, 0, 0 };
+                ++count;
+                return true;
+            }
+
+            // Index of the slab holding `p`; `p` must belong to one of them.
+            IO_NODISCARD usize find(const void* p) const noexcept {
+                const u8* q = static_cast<const u8*>(p);
+                usize lo = 0, hi = count;
+                while (hi - lo > 1) {
+                    const usize mid = (lo + hi) / 2;
+                    if (slabs[mid].base <= q) lo = mid;
+                    else hi = mid;
+                }
+                return lo;
+            }
+
+            // A discarded slab to carve again instead of mapping a new one.
+            IO_NODISCARD u8* reuse() noexcept {
+                for (usize i = 0; i < count; ++i) {
+                    if (!slabs[i].discarded) continue;
+                    slabs[i].discarded = 0;
+                    return slabs[i].base;
+                }
+                return nullptr;
+            }
+
+        private:
+            IO_NODISCARD bool grow() noexcept {
+                const usize page = io::page_size();
+                const usize bytes = capacity ? capacity * sizeof(Slab) * 2 : page;
+                Slab* fresh = static_cast<Slab*>(io::map_pages(bytes));
+                if (!fresh) return false;
+                for (usize i = 0; i < count; ++i) fresh[i] = slabs[i];
+                if (slabs) io::unmap_pages(slabs, capacity * sizeof(Slab));
+                slabs = fresh;
+                capacity = bytes / sizeof(Slab);
+                return true;
+            }
+        }; // struct SlabRegistry
+
+        // Statistics hooks, defined with the size classes below.
+        IO_NODISCARD inline usize pool_index(usize size) noexcept;
+        inline void stat_syscall(usize idx) noexcept;
+
         // ------------------------- Slot Pool ---------------------------------
         struct ISlotPool {
             virtual void* allocate() noexcept = 0;
             virtual void deallocate(void* ptr) noexcept = 0;
+
+            // Batch exchange with thread caches: pop up to `max` slots as a linked
+            // chain (returns the count), or push a linked chain [first..last] back.
+            virtual usize allocate_batch(FreeNode*& out_head, usize max) noexcept = 0;
+            virtual void deallocate_batch(FreeNode* first, FreeNode* last) noexcept = 0;
+
+            // Return the pages of fully free slabs to the OS; returns bytes released.
+            virtual usize trim() noexcept = 0;
         };
 
-        template <usize BlockSize>
+        template <usize BlockSize, usize SlabBytes = IO_SLOT_SLAB_BYTES>
         struct SlotPool : ISlotPool {
-            atomic<FreeNode*> free_list = nullptr;
+            static_assert(BlockSize >= sizeof(FreeNode), "slot must fit a free-list link");
+            static_assert(BlockSize % DEFAULT_ALIGNMENT == 0 || DEFAULT_ALIGNMENT % BlockSize == 0, "slot alignment");
+            static_assert(SlabBytes >= BlockSize * 2, "slab too small for its size class");
+            static_assert(SlabBytes % ChunkMap::CHUNK_BYTES == 0, "slab must be a whole number of chunks");
+
+            static IO_CONSTEXPR_VAR usize BLOCK_SIZE = BlockSize;
+            static IO_CONSTEXPR_VAR usize SLAB_BYTES = SlabBytes;
+
+            TaggedStack free_list;
 
             explicit SlotPool() noexcept = default;
+            static IO_CONSTEXPR_VAR usize SLOTS = SlabBytes / BlockSize;
+            // Slots carved ahead of demand: at most about one page (one slot
+            // for page-sized and larger classes).
+            static IO_CONSTEXPR_VAR usize CARVE_BATCH = BlockSize < 4096 ? 4096 / BlockSize : 1;
 
             void* allocate() noexcept override {
-                FreeNode* node;
-                do {
-                    node = free_list.load(memory_order_acquire);
-                    if (!node) return io::alloc(BlockSize);
-                } while (!free_list.compare_exchange_strong(node, node->next, memory_order_acq_rel));
-                return node;
+                if (FreeNode* node = pop()) return node;
+                usize got = 0;
+                return carve(1, got);
             } // allocate
 
             void deallocate(void* ptr) noexcept override {
-                FreeNode* old_head;
                 FreeNode* node = static_cast<FreeNode*>(ptr);
-                do {
-                    old_head = free_list.load(memory_order_acquire);
-                    node->next = old_head;
-                } while (!free_list.compare_exchange_strong(old_head, node, memory_order_acq_rel));
-
+                push_chain(node, node);
             } // deallocate
+
+            usize allocate_batch(FreeNode*& out_head, usize max) noexcept override {
+                out_head = nullptr;
+                usize n = 0;
+                while (n < max) {
+                    FreeNode* node = pop();
+                    if (!node) break;
+                    node->store_next(out_head);
+                    out_head = node;
+                    ++n;
+                }
+                if (n == 0) out_head = carve(max, n);
+                return n;
+            } // allocate_batch
+
+            void deallocate_batch(FreeNode* first, FreeNode* last) noexcept override {
+                if (first) push_chain(first, last);
+            } // deallocate_batch
+
+            // Slots parked in thread caches keep their slab alive; flush first.
+            // Slabs are discarded, not unmapped: a concurrent pop may still read
+            // `next` from a slot it saw before take_all(), which must stay mapped.
+            usize trim() noexcept override {
+                FreeNode* chain = free_list.take_all();
+                if (!chain) return 0;
+
+                _lock.lock();
+                for (usize i = 0; i < _slabs.count; ++i) _slabs.slabs[i].free = 0;
+                for (FreeNode* n = chain; n; n = n->next) ++_slabs.slabs[_slabs.find(n)].free;
+                // the not yet carved tail of the current slab counts as free
+                if (_bump != _bump_end)
+                    _slabs.slabs[_slabs.find(_bump)].free += static_cast<u32>((_bump_end - _bump) / BlockSize);
+
+                // keep the slots of slabs still in use, drop the rest
+                FreeNode* keep = nullptr;
+                FreeNode* keep_last = nullptr;
+                for (FreeNode* n = chain; n;) {
+                    FreeNode* next = n->next;
+                    if (_slabs.slabs[_slabs.find(n)].free != SLOTS) {
+                        n->store_next(keep);
+                        keep = n;
+                        if (!keep_last) keep_last = n;
+                    }
+                    n = next;
+                }
+
+                usize released = 0;
+                for (usize i = 0; i < _slabs.count; ++i) {
+                    SlabRegistry::Slab& slab = _slabs.slabs[i];
+                    if (slab.free != SLOTS) continue;
+                    io::discard_pages(slab.base, SlabBytes);
+                    stat_syscall(pool_index(BlockSize));
+                    slab.discarded = 1;
+                    released += SlabBytes;
+                }
+                if (_bump != _bump_end && _slabs.slabs[_slabs.find(_bump)].discarded)
+                    _bump = _bump_end = nullptr; // carved again from the start via reuse()
+                _lock.unlock();
+
+                if (keep) push_chain(keep, keep_last);
+                return released;
+            } // trim
+
+        private:
+            SpinLock     _lock;
+            SlabRegistry _slabs;
+            u8*          _bump{ nullptr };     // next uncarved slot of the current slab
+            u8*          _bump_end{ nullptr };
+
+            IO_NODISCARD FreeNode* pop() noexcept { return free_list.pop(); }
+            void push_chain(FreeNode* first, FreeNode* last) noexcept { free_list.push(first, last); }
+
+            // Slow path: hands out the next `take` slots of the current slab as a
+            // chain and publishes at most CARVE_BATCH more on the free list, so a
+            // slab's pages are faulted in as its slots are first used rather than
+            // all at once. Past the end of the slab, the next one is a slab
+            // discarded by trim() or a new mapping.
+            FreeNode* carve(usize take, usize& taken) noexcept {
+                taken = 0;
+                _lock.lock();
+                if (_bump == _bump_end && !next_slab()) {
+                    _lock.unlock();
+                    return nullptr;
+                }
+                const usize avail = static_cast<usize>(_bump_end - _bump) / BlockSize;
+                if (take > avail) take = avail;
+                const usize extra = avail - take < CARVE_BATCH ? avail - take : CARVE_BATCH;
+                u8* const first = _bump;
+                _bump += (take + extra) * BlockSize;
+                _lock.unlock();
+
+                auto slot = [first](usize i) noexcept { return reinterpret_cast<FreeNode*>(first + i * BlockSize); };
+                const usize n = take + extra;
+                for (usize i = 0; i + 1 < n; ++i) slot(i)->store_next(slot(i + 1));
+                slot(n - 1)->store_next(nullptr);
+                if (extra) {
+                    slot(take - 1)->store_next(nullptr);
+                    push_chain(slot(take), slot(n - 1));
+                }
+                taken = take;
+                return slot(0);
+            } // carve
+
+            // Points [_bump, _bump_end) at a fresh slab: one chunk-aligned
+            // mapping, tagged with the slot size in the chunk map. Caller holds
+            // the lock; refills that find the slab exhausted wait for this one.
+            IO_NODISCARD bool next_slab() noexcept {
+                u8* slab = _slabs.reuse();
+                if (!slab) {
+                    slab = static_cast<u8*>(io::map_pages_aligned(SlabBytes, ChunkMap::CHUNK_BYTES));
+                    stat_syscall(pool_index(BlockSize));
+                    if (!slab) return false;
+                    if (!global::chunk_map.set(slab, SlabBytes, static_cast<u32>(BlockSize))) {
+                        io::unmap_pages(slab, SlabBytes);
+                        return false;
+                    }
+                    if (!_slabs.insert(slab)) {
+                        (void)global::chunk_map.set(slab, SlabBytes, 0);
+                        io::unmap_pages(slab, SlabBytes);
+                        return false;
+                    }
+                }
+                _bump = slab;
+                _bump_end = slab + SlabBytes;
+                return true;
+            } // next_slab
         }; // struct SlotPool
 
+        using Pool8   = SlotPool<8,   IO_SLOT_SLAB_BYTES_8>;
+        using Pool16  = SlotPool<16,  IO_SLOT_SLAB_BYTES_16>;
+        using Pool32  = SlotPool<32,  IO_SLOT_SLAB_BYTES_32>;
+        using Pool64  = SlotPool<64,  IO_SLOT_SLAB_BYTES_64>;
+        using Pool128 = SlotPool<128, IO_SLOT_SLAB_BYTES_128>;
+        using Pool256 = SlotPool<256, IO_SLOT_SLAB_BYTES_256>;
+        using Pool512   = SlotPool<512,   IO_SLOT_SLAB_BYTES_512>;
+        using Pool1024  = SlotPool<1024,  IO_SLOT_SLAB_BYTES_1024>;
+        using Pool2048  = SlotPool<2048,  IO_SLOT_SLAB_BYTES_2048>;
+        using Pool4096  = SlotPool<4096,  IO_SLOT_SLAB_BYTES_4096>;
+        using Pool8192  = SlotPool<8192,  IO_SLOT_SLAB_BYTES_8192>;
+        using Pool16384 = SlotPool<16384, IO_SLOT_SLAB_BYTES_16384>;
+        using Pool32768 = SlotPool<32768, IO_SLOT_SLAB_BYTES_32768>;
+        using Pool65536 = SlotPool<65536, IO_SLOT_SLAB_BYTES_65536>;
+
         // ---------------------- Global Slot Pools ---------------------------
-        static SlotPool<8>   pool8;
-        static SlotPool<16>  pool16;
-        static SlotPool<32>  pool32;
-        static SlotPool<64>  pool64;
-        static SlotPool<128> pool128;
-        static SlotPool<256> pool256;
+        namespace global { // defined in source.cpp
+            extern Pool8   pool8;
+            extern Pool16  pool16;
+            extern Pool32  pool32;
+            extern Pool64  pool64;
+            extern Pool128 pool128;
+            extern Pool256 pool256;
+            extern Pool512   pool512;
+            extern Pool1024  pool1024;
+            extern Pool2048  pool2048;
+            extern Pool4096  pool4096;
+            extern Pool8192  pool8192;
+            extern Pool16384 pool16384;
+            extern Pool32768 pool32768;
+            extern Pool65536 pool65536;
+        } // namespace global
 
         // ---------------------- Helper --------------------------------------
-        inline SlotPool<8>* select_pool8(usize size) { if (size <= 8) return &pool8; return nullptr; }
-        inline SlotPool<16>* select_pool16(usize size) { if (size <= 16) return &pool16; return nullptr; }
-        inline SlotPool<32>* select_pool32(usize size) { if (size <= 32) return &pool32; return nullptr; }
-        inline SlotPool<64>* select_pool64(usize size) { if (size <= 64) return &pool64; return nullptr; }
-        inline SlotPool<128>* select_pool128(usize size) { if (size <= 128) return &pool128; return nullptr; }
-        inline SlotPool<256>* select_pool256(usize size) { if (size <= 256) return &pool256; return nullptr; }
+        inline Pool8* select_pool8(usize size) { if (size <= 8) return &global::pool8; return nullptr; }
+        inline Pool16* select_pool16(usize size) { if (size <= 16) return &global::pool16; return nullptr; }
+        inline Pool32* select_pool32(usize size) { if (size <= 32) return &global::pool32; return nullptr; }
+        inline Pool64* select_pool64(usize size) { if (size <= 64) return &global::pool64; return nullptr; }
+        inline Pool128* select_pool128(usize size) { if (size <= 128) return &global::pool128; return nullptr; }
+        inline Pool256* select_pool256(usize size) { if (size <= 256) return &global::pool256; return nullptr; }
 
         // ---------------------- Unified Select -----------------------------
+        // Power-of-two classes 8 B .. 64 KiB; anything larger gets its own mapping.
+        static ISlotPool* const pools[] = {
+            &global::pool8, &global::pool16, &global::pool32,
+            &global::pool64, &global::pool128, &global::pool256,
+            &global::pool512, &global::pool1024, &global::pool2048, &global::pool4096,
+            &global::pool8192, &global::pool16384, &global::pool32768, &global::pool65536 };
+        static IO_CONSTEXPR_VAR usize POOL_COUNT = sizeof(pools) / sizeof(pools[0]);
+        static IO_CONSTEXPR_VAR usize MAX_POOLED = usize(8) << (POOL_COUNT - 1);
+
+        inline usize pool_index(usize size) noexcept {
+            if (size <= 8) return 0;
+            if (size > MAX_POOLED) return POOL_COUNT; // large object -> own mapping
+
+            // ceil(log2(size)) - 3
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<usize>(64 - __builtin_clzll(static_cast<u64>(size - 1))) - 3;
+#elif defined(_MSC_VER) && defined(_WIN64)
+            unsigned long top;
+            ::_BitScanReverse64(&top, static_cast<u64>(size - 1));
+            return static_cast<usize>(top) + 1 - 3;
+#else
+            usize idx = 0;
+            for (usize s = (size - 1) >> 3; s; s >>= 1) ++idx;
+            return idx;
+#endif
+        }
+
+        IO_NODISCARD IO_CONSTEXPR usize pool_block_size(usize idx) noexcept { return usize(8) << idx; }
+
         inline ISlotPool* pool_for_size(usize size) {
-            if (size <= 8) return &pool8;
-            if (size <= 16) return &pool16;
-            if (size <= 32) return &pool32;
-            if (size <= 64) return &pool64;
-            if (size <= 128) return &pool128;
-            if (size <= 256) return &pool256;
-            return nullptr; // large object -> use io::alloc
+            const usize idx = pool_index(size);
+            return idx < POOL_COUNT ? pools[idx] : nullptr;
         }
 
-        static inline void* allocate_block(usize size) {
-            const usize total = sizeof(BlockHeader) + size;
+        // ---------------------- Statistics ----------------------------------
+        // Counter slot POOL_COUNT stands for blocks above MAX_POOLED.
+        static IO_CONSTEXPR_VAR usize STAT_CLASSES = POOL_COUNT + 1;
+
+        struct AllocStats {
+            struct Class {
+                usize block_size; // slot size; 0 for the large class
+                u64 allocs;
+                u64 frees;
+                u64 live_bytes;   // counted in whole slots / mapped bytes
+                u64 peak_bytes;
+                u64 refills;      // thread cache refills from the shared pool
+                u64 syscalls;     // slab / large mappings, unmaps, discards
+            };
+
+#ifdef IO_ALLOC_STATS
+            static IO_CONSTEXPR_VAR bool enabled = true;
+#else
+            static IO_CONSTEXPR_VAR bool enabled = false;
+#endif
+            Class classes[STAT_CLASSES];
+            Class total; // peak_bytes: high-water mark of all classes together
+        };
+
+#ifdef IO_ALLOC_STATS
+        struct alignas(64) ClassCounters {
+            atomic<u64> allocs{ 0 };
+            atomic<u64> frees{ 0 };
+            atomic<u64> live_bytes{ 0 };
+            atomic<u64> peak_bytes{ 0 };
+            atomic<u64> refills{ 0 };
+            atomic<u64> syscalls{ 0 };
+        };
+
+        struct AllocCounters {
+            ClassCounters classes[STAT_CLASSES];
+            ClassCounters total;
+        };
+
+        namespace global {
+            extern AllocCounters alloc_counters; // defined in source.cpp
+        } // namespace global
+
+        inline void stat_raise_peak(atomic<u64>& peak, u64 live) noexcept {
+            u64 seen = peak.load(memory_order_relaxed);
+            while (seen < live && !peak.compare_exchange_strong(seen, live, memory_order_relaxed, memory_order_relaxed)) {}
+        }
+
+        inline void stat_alloc(usize idx, usize bytes) noexcept {
+            ClassCounters* const counters[2] = { &global::alloc_counters.classes[idx], &global::alloc_counters.total };
+            for (ClassCounters* c : counters) {
+                (void)c->allocs.fetch_add(1, memory_order_relaxed);
+                stat_raise_peak(c->peak_bytes, c->live_bytes.fetch_add(bytes, memory_order_relaxed) + bytes);
+            }
+        }
+        inline void stat_free(usize idx, usize bytes) noexcept {
+            ClassCounters* const counters[2] = { &global::alloc_counters.classes[idx], &global::alloc_counters.total };
+            for (ClassCounters* c : counters) {
+                (void)c->frees.fetch_add(1, memory_order_relaxed);
+                (void)c->live_bytes.fetch_sub(bytes, memory_order_relaxed);
+            }
+        }
+        inline void stat_refill(usize idx) noexcept {
+            (void)global::alloc_counters.classes[idx].refills.fetch_add(1, memory_order_relaxed);
+            (void)global::alloc_counters.total.refills.fetch_add(1, memory_order_relaxed);
+        }
+        inline void stat_syscall(usize idx) noexcept {
+            (void)global::alloc_counters.classes[idx].syscalls.fetch_add(1, memory_order_relaxed);
+            (void)global::alloc_counters.total.syscalls.fetch_add(1, memory_order_relaxed);
+        }
 
-            if (auto pool = pool_for_size(total)) {
-                void* raw = pool->allocate();
-                if (!raw) return nullptr;
+        // Counters are read one by one; the result is not an atomic snapshot.
+        inline AllocStats alloc_stats() noexcept {
+            auto read = [](const ClassCounters& c, usize block_size) noexcept {
+                return AllocStats::Class{ block_size,
+                    c.allocs.load(memory_order_relaxed), c.frees.load(memory_order_relaxed),
+                    c.live_bytes.load(memory_order_relaxed), c.peak_bytes.load(memory_order_relaxed),
+                    c.refills.load(memory_order_relaxed), c.syscalls.load(memory_order_relaxed) };
+            };
+            AllocStats out{};
+            for (usize idx = 0; idx < STAT_CLASSES; ++idx)
+                out.classes[idx] = read(global::alloc_counters.classes[idx], idx < POOL_COUNT ? pool_block_size(idx) : 0);
+            out.total = read(global::alloc_counters.total, 0);
+            return out;
+        }
+#else
+        inline void stat_alloc(usize, usize) noexcept {}
+        inline void stat_free(usize, usize) noexcept {}
+        inline void stat_refill(usize) noexcept {}
+        inline void stat_syscall(usize) noexcept {}
+
+        inline AllocStats alloc_stats() noexcept {
+            AllocStats out{};
+            for (usize idx = 0; idx < POOL_COUNT; ++idx) out.classes[idx].block_size = pool_block_size(idx);
+            return out;
+        }
+#endif // IO_ALLOC_STATS
+
+        // ---------------------- Trim Policy ---------------------------------
+        // Automatic trimming, off by default. Once enabled, a thread returning
+        // slots on the slow path calls trim() if `interval_seconds` passed
+        // since the last trim, so idle memory drifts back to the OS without a
+        // dedicated thread. The disabled check is a single relaxed load.
+        struct TrimPolicy {
+            double interval_seconds{ 0. }; // 0 = off
+        };
+
+        struct TrimState {
+            atomic<u64> interval_ms{ 0 };
+            atomic<u64> next_ms{ 0 };
+        };
+
+        namespace global {
+            extern TrimState trim_state; // defined in source.cpp
+        } // namespace global
+
+        inline void trim_tick() noexcept;
+
+        // ---------------------- Thread Cache --------------------------------
+        struct Magazine {
+            FreeNode* head;
+            usize count;
+        };
+        static_assert(IO_MAGAZINE_SLOTS >= 2, "magazine needs room for two slots");
+
+        IO_NODISCARD IO_CONSTEXPR usize magazine_slots(usize idx) noexcept {
+            return IO_MAGAZINE_BYTES / pool_block_size(idx) >= IO_MAGAZINE_SLOTS ? IO_MAGAZINE_SLOTS
+                : IO_MAGAZINE_BYTES / pool_block_size(idx) >= 2 ? IO_MAGAZINE_BYTES / pool_block_size(idx)
+                : 2;
+        }
+        IO_NODISCARD IO_CONSTEXPR usize magazine_batch(usize idx) noexcept { return magazine_slots(idx) / 2; }
+
+#ifndef IO_NO_THREAD_CACHE
+        // Hands every slot in `mags` back to the shared pools.
+        inline void flush_magazines(Magazine* mags) noexcept {
+            for (usize idx = 0; idx < POOL_COUNT; ++idx) {
+                Magazine& m = mags[idx];
+                if (!m.head) continue;
+                FreeNode* last = m.head;
+                while (last->next) last = last->next;
+                pools[idx]->deallocate_batch(m.head, last);
+                m.head = nullptr;
+                m.count = 0;
+            }
+        }
+
+#   ifdef IO_THREAD_CACHE_KEYED
+        // One pool256 slot per thread holds its magazines; the key's destructor
+        // flushes them and gives the slot back. A thread past that point keeps
+        // the key object's own address as its value and bypasses the cache.
+        struct ThreadCacheKey {
+            enum : u32 { NONE, CREATING, READY, FAILED };
+            atomic<u32> state{ NONE };
+            thread_key key{};
+        };
+        static_assert(sizeof(Magazine) * POOL_COUNT <= 256, "thread magazines must fit a 256-byte slot");
+
+        namespace global { // defined in source.cpp
+            extern ThreadCacheKey thread_cache_key;
+        } // namespace global
+
+        inline void IO_THREAD_KEY_CALLBACK thread_cache_exit(void* block) noexcept {
+            if (block == &global::thread_cache_key) return;
+            (void)thread_key_set(global::thread_cache_key.key, &global::thread_cache_key);
+            flush_magazines(static_cast<Magazine*>(block));
+            global::pool256.deallocate(block);
+        }
+
+        // The calling thread's magazines, or nullptr if it has none (yet).
+        IO_NODISCARD inline Magazine* current_magazines() noexcept {
+            if (global::thread_cache_key.state.load(memory_order_acquire) != ThreadCacheKey::READY) return nullptr;
+            void* block = thread_key_get(global::thread_cache_key.key);
+            return block == &global::thread_cache_key ? nullptr : static_cast<Magazine*>(block);
+        }
+
+        // Slow path of `thread_magazines()`: creates the key on first use and
+        // the calling thread's magazines after that. nullptr means "use the
+        // shared pools directly" (key still being created, or out of memory).
+        inline Magazine* create_thread_magazines() noexcept {
+            ThreadCacheKey& tc = global::thread_cache_key;
+            u32 state = tc.state.load(memory_order_acquire);
+            if (state == ThreadCacheKey::NONE
+                && tc.state.compare_exchange_strong(state, ThreadCacheKey::CREATING, memory_order_acquire, memory_order_acquire)) {
+                state = thread_key_create(tc.key, &thread_cache_exit) ? ThreadCacheKey::READY : ThreadCacheKey::FAILED;
+                tc.state.store(state, memory_order_release);
+            }
+            if (state != ThreadCacheKey::READY) return nullptr;
+
+            void* block = thread_key_get(tc.key);
+            if (block) return block == &tc ? nullptr : static_cast<Magazine*>(block);
+            block = global::pool256.allocate();
+            if (!block) return nullptr;
+            Magazine* mags = static_cast<Magazine*>(block);
+            for (usize idx = 0; idx < POOL_COUNT; ++idx) mags[idx] = Magazine{ nullptr, 0 };
+            if (!thread_key_set(tc.key, block)) {
+                global::pool256.deallocate(block);
+                return nullptr;
+            }
+            return mags;
+        }
+
+        IO_NODISCARD inline Magazine* thread_magazines() noexcept {
+            if (global::thread_cache_key.state.load(memory_order_acquire) == ThreadCacheKey::READY) {
+                void* block = thread_key_get(global::thread_cache_key.key);
+                if (block && block != &global::thread_cache_key) return static_cast<Magazine*>(block);
+            }
+            return create_thread_magazines();
+        }
+
+        inline void arm_thread_cache() noexcept {}
+#   else
+        inline void flush_thread_cache() noexcept;
+
+        // Its destructor flushes the exiting thread's magazines. The object is
+        // touched only once per thread, from the slow path, which is what
+        // registers the destructor; the fast path never goes through it.
+        struct ThreadCacheExit {
+            IO_CONSTEXPR ThreadCacheExit() noexcept = default;
+            ~ThreadCacheExit() noexcept { flush_thread_cache(); }
+            void arm() noexcept {}
+        };
+
+        namespace global { // defined in source.cpp
+            extern thread_local Magazine magazines[POOL_COUNT];
+            extern thread_local bool thread_cache_armed;
+            extern thread_local ThreadCacheExit thread_cache_exit;
+        } // namespace global
+
+        IO_NODISCARD inline Magazine* current_magazines() noexcept { return global::magazines; }
+        IO_NODISCARD inline Magazine* thread_magazines() noexcept { return global::magazines; }
+
+        // Slots parked by thread_local destructors that run after the flush
+        // stay in the dead thread's magazines; it is never re-armed.
+        inline void arm_thread_cache() noexcept {
+            if (global::thread_cache_armed) return;
+            global::thread_cache_armed = true;
+            global::thread_cache_exit.arm();
+        }
+#   endif // IO_THREAD_CACHE_KEYED
+
+        inline void* allocate_slot(usize idx) noexcept {
+            Magazine* mags = thread_magazines();
+            if (!mags) return pools[idx]->allocate();
+            Magazine& m = mags[idx];
+            if (!m.head) {
+                arm_thread_cache();
+                stat_refill(idx);
+                m.count = pools[idx]->allocate_batch(m.head, magazine_batch(idx));
+                if (!m.head) return nullptr;
+            }
+            FreeNode* node = m.head;
+            m.head = node->next;
+            --m.count;
+            return node;
+        }
+
+        inline void deallocate_slot(usize idx, void* ptr) noexcept {
+            Magazine* mags = thread_magazines();
+            if (!mags) {
+                pools[idx]->deallocate(ptr);
+                return;
+            }
+            Magazine& m = mags[idx];
+            if (!m.head) arm_thread_cache(); // freed on a thread that never allocated
+            FreeNode* node = static_cast<FreeNode*>(ptr);
+            node->store_next(m.head);
+            m.head = node;
+            if (++m.count < magazine_slots(idx)) return;
+
+            // full: keep the recently freed (cache-hot) front, give the tail back
+            const usize keep = m.count - magazine_batch(idx);
+            FreeNode* split = m.head;
+            for (usize i = 1; i < keep; ++i) split = split->next;
+            FreeNode* first = split->next;
+            FreeNode* last = first;
+            while (last->next) last = last->next;
+            split->store_next(nullptr);
+            m.count = keep;
+            pools[idx]->deallocate_batch(first, last);
+            trim_tick();
+        }
+
+        // Return everything cached by the calling thread to the shared pools.
+        // Runs by itself when the thread exits; call it to hand slots back sooner.
+        inline void flush_thread_cache() noexcept {
+            if (Magazine* mags = current_magazines()) flush_magazines(mags);
+        }
+#else
+        inline void* allocate_slot(usize idx) noexcept { return pools[idx]->allocate(); }
+        inline void deallocate_slot(usize idx, void* ptr) noexcept {
+            pools[idx]->deallocate(ptr);
+            // a slab only turns fully free once the slot at the start of each
+            // of its chunks is back, so only those frees look at the clock
+            if ((reinterpret_cast<usize>(ptr) & (ChunkMap::CHUNK_BYTES - 1)) == 0) trim_tick();
+        }
+        inline void flush_thread_cache() noexcept {}
+#endif // IO_NO_THREAD_CACHE
+
+        // ---------------------- Trim ----------------------------------------
+        // Flushes the calling thread's cache, then gives the pages of every
+        // fully free slab back to the OS (the address range stays reserved
+        // and is reused by the next refill). Returns the bytes released.
+        inline usize trim() noexcept {
+            flush_thread_cache();
+            usize released = 0;
+            for (usize idx = 0; idx < POOL_COUNT; ++idx) released += pools[idx]->trim();
+            return released;
+        }
+
+        inline void set_trim_policy(TrimPolicy policy) noexcept {
+            const u64 ms = policy.interval_seconds > 0. ? static_cast<u64>(policy.interval_seconds * 1000.) + 1 : 0;
+            global::trim_state.next_ms.store(0, memory_order_relaxed);
+            global::trim_state.interval_ms.store(ms, memory_order_relaxed);
+        }
+
+        inline void trim_tick() noexcept {
+            const u64 interval = global::trim_state.interval_ms.load(memory_order_relaxed);
+            if (!interval) return;
+
+            const u64 now = static_cast<u64>(io::monotonic_seconds() * 1000.);
+            u64 due = global::trim_state.next_ms.load(memory_order_relaxed);
+            if (now < due) return;
+            // one thread wins the slot, the others carry on
+            if (!global::trim_state.next_ms.compare_exchange_strong(due, now + interval, memory_order_relaxed, memory_order_relaxed))
+                return;
+            (void)trim();
+        }
 
-                auto* hdr = static_cast<BlockHeader*>(raw);
-                hdr->size = total;
-                return hdr + 1;
+        // ---------------------- Large Blocks ------------------------------
+        // Above MAX_POOLED: a dedicated chunk-aligned (so page-aligned) mapping,
+        // registered in the chunk map with its length, unmapped on free.
+
+        // Largest request that still rounds up to a whole chunk without wrapping.
+        static IO_CONSTEXPR_VAR usize MAX_LARGE = ~usize(0) - ChunkMap::CHUNK_BYTES;
+
+        IO_NODISCARD inline usize large_bytes(usize size) noexcept {
+            return (size + ChunkMap::CHUNK_BYTES - 1) & ~(ChunkMap::CHUNK_BYTES - 1);
+        }
+
+        // `align` above CHUNK_BYTES places the mapping on that boundary instead.
+        static inline void* allocate_large(usize size, usize align = ChunkMap::CHUNK_BYTES) noexcept {
+            if (size > MAX_LARGE) return nullptr;
+            const usize bytes = large_bytes(size);
+            void* p = io::map_pages_aligned(bytes, align);
+            stat_syscall(POOL_COUNT);
+            if (!p) return nullptr;
+            const u32 tag = ChunkMap::LARGE | static_cast<u32>(bytes >> ChunkMap::CHUNK_SHIFT);
+            if (!global::chunk_map.set(p, bytes, tag)) {
+                io::unmap_pages(p, bytes);
+                return nullptr;
             }
+            stat_alloc(POOL_COUNT, bytes);
+            return p;
+        }
 
-            auto* hdr = static_cast<BlockHeader*>(io::alloc(total));
-            if (!hdr) return nullptr;
-            hdr->size = total;
-            return hdr + 1;
+        static inline void deallocate_large(void* ptr, usize bytes) noexcept {
+            (void)global::chunk_map.set(ptr, bytes, 0);
+            io::unmap_pages(ptr, bytes);
+            stat_free(POOL_COUNT, bytes);
+            stat_syscall(POOL_COUNT);
         }
 
+        // ---------------------- Entry Points ------------------------------
+
+        static inline void* allocate_block(usize size) {
+            const usize idx = pool_index(size);
+            if (idx < POOL_COUNT) { // header-free
+                void* p = allocate_slot(idx);
+                if (p) stat_alloc(idx, pool_block_size(idx));
+                return p;
+            }
+            return allocate_large(size);
+        }
+
+        // Unsized: the chunk map knows the slot size (or length) of every block.
         static inline void deallocate_block(void* ptr) noexcept {
             if (!ptr) return;
 
-            auto* hdr = static_cast<BlockHeader*>(ptr) - 1;
-            const usize total = hdr->size;
+            const u32 tag = global::chunk_map.get(ptr);
+            if (tag == 0) { // not from a slab or large mapping (e.g. io::alloc)
+                IO_ALLOC_MISUSE();
+                return;
+            }
+            if (tag & ChunkMap::LARGE) {
+                deallocate_large(ptr, static_cast<usize>(tag & ~ChunkMap::LARGE) << ChunkMap::CHUNK_SHIFT);
+                return;
+            }
+            const usize idx = pool_index(tag);
+            stat_free(idx, tag);
+            deallocate_slot(idx, ptr);
+        }
+
+        // Sized (`operator delete(void*, size_t)`): no lookup at all.
+        static inline void deallocate_block(void* ptr, usize size) noexcept {
+            if (!ptr) return;
+
+            const usize idx = pool_index(size);
+            if (idx < POOL_COUNT) {
+                stat_free(idx, pool_block_size(idx));
+                deallocate_slot(idx, ptr);
+            }
+            else deallocate_large(ptr, large_bytes(size));
+        }
+
+        // ---------------------- Aligned Blocks ----------------------------
+        // A power-of-two slot sits at a multiple of its size in a chunk-aligned
+        // slab, and large blocks are chunk-aligned: any block of at least
+        // `align` bytes is `align`-aligned up to CHUNK_BYTES. Larger alignments
+        // get a large mapping placed on the boundary. Free with the unsized
+        // `deallocate_block(ptr)` or with `deallocate_block_aligned`.
+
+        IO_NODISCARD inline usize aligned_block_size(usize size, usize align) noexcept {
+            return size < align ? align : size;
+        }
+
+        static inline void* allocate_block_aligned(usize size, usize align) {
+            const usize bytes = aligned_block_size(size, align);
+            if (align <= ChunkMap::CHUNK_BYTES) return allocate_block(bytes);
+            return allocate_large(bytes, align);
+        }
+
+        static inline void deallocate_block_aligned(void* ptr, usize size, usize align) noexcept {
+            deallocate_block(ptr, aligned_block_size(size, align));
+        }
+
+        // Large -> large resize through remap_pages (no copy); nullptr if the
+        // OS can't, with the block untouched.
+        //
+        // Same order as deallocate_large: the old tags are cleared before the
+        // remap gives any of those chunks back (the whole range when the block
+        // moves, the tail when it shrinks), so a slab or block another thread
+        // maps there in the meantime never has its fresh tags zeroed by us.
+        // Clearing only touches leaves that already exist, so it cannot fail.
+        static inline void* reallocate_large(void* ptr, usize old_bytes, usize new_bytes, usize align) noexcept {
+            if (old_bytes == new_bytes) return ptr;
+            const u32 old_tag = ChunkMap::LARGE | static_cast<u32>(old_bytes >> ChunkMap::CHUNK_SHIFT);
+            (void)global::chunk_map.set(ptr, old_bytes, 0);
+
+            void* p = io::remap_pages(ptr, old_bytes, new_bytes, align);
+            if (!p) {
+                (void)global::chunk_map.set(ptr, old_bytes, old_tag);
+                return nullptr;
+            }
+            stat_syscall(POOL_COUNT);
+            stat_free(POOL_COUNT, old_bytes);
+            stat_alloc(POOL_COUNT, new_bytes);
+
+            // a leaf can only fail to map when out of memory; the sized path
+            // (`deallocate_block(p, size)`) does not depend on the tags
+            const u32 tag = ChunkMap::LARGE | static_cast<u32>(new_bytes >> ChunkMap::CHUNK_SHIFT);
+            (void)global::chunk_map.set(p, new_bytes, tag);
+            return p;
+        }
+
+        // Resizes a block, keeping its first min(old_size, new_size) bytes; for
+        // trivially relocatable contents only. Same size class: nothing to do.
+        // Large -> large: pages are remapped instead of copied where possible.
+        // `align` as given to allocate_block_aligned (1 for plain blocks).
+        // Returns nullptr when out of memory; `ptr` then stays valid.
+        static inline void* reallocate_block(void* ptr, usize old_size, usize new_size, usize align = 1) noexcept {
+            old_size = aligned_block_size(old_size, align);
+            new_size = aligned_block_size(new_size, align);
+            if (!ptr) return allocate_block_aligned(new_size, align);
+            if (new_size > MAX_LARGE) return nullptr;
+
+            const usize old_idx = pool_index(old_size);
+            const usize new_idx = pool_index(new_size);
+            if (old_idx == new_idx && old_idx < POOL_COUNT) return ptr;
+            if (old_idx == POOL_COUNT && new_idx == POOL_COUNT) {
+                const usize boundary = align < ChunkMap::CHUNK_BYTES ? ChunkMap::CHUNK_BYTES : align;
+                if (void* p = reallocate_large(ptr, large_bytes(old_size), large_bytes(new_size), boundary)) return p;
+            }
 
-            if (auto pool = pool_for_size(total))
-                pool->deallocate(hdr);
-            else
-                io::free(hdr);
+            void* p = allocate_block_aligned(new_size, align);
+            if (!p) return nullptr;
+            io::mem::copy(p, ptr, old_size < new_size ? old_size : new_size);
+            deallocate_block(ptr, old_size);
+            return p;
         }
 
     } // namespace native
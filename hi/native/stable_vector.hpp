@@ -0,0 +1,164 @@
+#pragma once
+#include "types.hpp"
+#include "syscalls.hpp"
+
+// -------------------- Stable vector reservation -----------------------------
+// Address space a stable_vector reserves by default (not memory: pages are
+// committed as the vector grows). Pass `max_count` to the constructor to
+// size one explicitly.
+#ifndef IO_STABLE_VECTOR_RESERVE_BYTES
+#   define IO_STABLE_VECTOR_RESERVE_BYTES (sizeof(void*) == 8 ? (usize(64) << 30) : (usize(256) << 20))
+#endif
+
+// Commit at least this much at a time, so small pushes don't syscall per page.
+#ifndef IO_STABLE_VECTOR_COMMIT_BYTES
+#   define IO_STABLE_VECTOR_COMMIT_BYTES (64u * 1024u)
+#endif
+
+namespace io {
+
+    // ------------------------- stable_vector ---------------------------
+    // Vector over one reserved virtual range: growth commits more pages at
+    // the end and never moves an element, so pointers and references stay
+    // valid until the element is removed. `max_size()` is fixed at
+    // construction; pushing past it fails. The range is reserved on first use.
+    template<typename T>
+    struct stable_vector {
+        using value_type = T;
+
+        explicit stable_vector(usize max_count = IO_STABLE_VECTOR_RESERVE_BYTES / sizeof(T)) noexcept
+            : _max{ max_count } {}
+
+        ~stable_vector() noexcept {
+            clear();
+            if (_ptr) io::unmap_pages(_ptr, _reserved);
+            _ptr = nullptr;
+            _cap = 0;
+        }
+
+        stable_vector(const stable_vector&) = delete;
+        stable_vector& operator=(const stable_vector&) = delete;
+
+        stable_vector(stable_vector&& o) noexcept
+            : _ptr{ o._ptr }, _len{ o._len }, _cap{ o._cap }, _max{ o._max }, _reserved{ o._reserved } {
+            o._ptr = nullptr;
+            o._len = o._cap = o._reserved = 0;
+        }
+
+        stable_vector& operator=(stable_vector&& o) noexcept {
+            if (this == &o) return *this;
+            this->~stable_vector();
+            new (this) stable_vector(static_cast<stable_vector&&>(o));
+            return *this;
+        }
+
+        // -------- view conversion --------
+        IO_NODISCARD view<T> as_view() noexcept { return view<T>(_ptr, _len); }
+        IO_NODISCARD view<const T> as_view() const noexcept { return view<const T>(_ptr, _len); }
+
+        // -------- capacity/size --------
+        IO_NODISCARD usize size() const noexcept { return _len; }
+        IO_NODISCARD usize capacity() const noexcept { return _cap; } // committed elements
+        IO_NODISCARD usize max_size() const noexcept { return _max; }
+        IO_NODISCARD bool empty() const noexcept { return _len == 0; }
+
+        // -------- iterators --------
+        IO_NODISCARD T* begin() noexcept { return _ptr; }
+        IO_NODISCARD T* end() noexcept { return _ptr + _len; }
+        IO_NODISCARD const T* begin() const noexcept { return _ptr; }
+        IO_NODISCARD const T* end() const noexcept { return _ptr + _len; }
+
+        // -------- data --------
+        IO_NODISCARD T* data() noexcept { return _ptr; }
+        IO_NODISCARD const T* data() const noexcept { return _ptr; }
+
+        // -------- element access --------
+        IO_NODISCARD T& operator[](usize i) noexcept { return _ptr[i]; }
+        IO_NODISCARD const T& operator[](usize i) const noexcept { return _ptr[i]; }
+
+        IO_NODISCARD T& front() noexcept { return _ptr[0]; }
+        IO_NODISCARD T& back() noexcept { return _ptr[_len - 1]; }
+        IO_NODISCARD const T& front() const noexcept { return _ptr[0]; }
+        IO_NODISCARD const T& back() const noexcept { return _ptr[_len - 1]; }
+
+        // -------- reserve / resize --------
+        // Commits pages for `new_cap` elements; nothing is moved.
+        IO_NODISCARD bool reserve(usize new_cap) noexcept {
+            if (new_cap <= _cap) return true;
+            if (new_cap > _max) return false;
+            if (!_ptr && !reserve_range()) return false;
+
+            // grow geometrically, in whole pages, within the reservation
+            const usize page = io::page_size();
+            usize want = _cap * 2;
+            if (want < new_cap) want = new_cap;
+            if (want > _max) want = _max;
+            usize bytes = want * sizeof(T);
+            if (bytes < IO_STABLE_VECTOR_COMMIT_BYTES) bytes = IO_STABLE_VECTOR_COMMIT_BYTES;
+            bytes = (bytes + page - 1) & ~(page - 1);
+            if (bytes > _reserved) bytes = _reserved;
+
+            const usize committed = (_cap * sizeof(T) + page - 1) & ~(page - 1);
+            if (bytes > committed &&
+                !io::commit_pages(reinterpret_cast<u8*>(_ptr) + committed, bytes - committed))
+                return false;
+            _cap = bytes / sizeof(T);
+            if (_cap > _max) _cap = _max;
+            return true;
+        }
+
+        // resize to n (value-initialize new elems)
+        IO_NODISCARD bool resize(usize n) noexcept {
+            if (n > _cap && !reserve(n)) return false;
+            for (usize i = _len; i < n; ++i) new (_ptr + i) T{};
+            for (usize i = _len; i > n; --i) _ptr[i - 1].~T();
+            _len = n;
+            return true;
+        }
+
+        // -------- modifiers --------
+        IO_NODISCARD bool push_back(const T& v) noexcept {
+            if (_len == _cap && !reserve(_len + 1)) return false;
+            new (_ptr + _len) T(v);
+            ++_len;
+            return true;
+        }
+
+        IO_NODISCARD bool push_back(T&& v) noexcept {
+            if (_len == _cap && !reserve(_len + 1)) return false;
+            new (_ptr + _len) T(io::move(v));
+            ++_len;
+            return true;
+        }
+
+        void pop_back() noexcept {
+            if (_len == 0) return;
+            --_len;
+            _ptr[_len].~T();
+        }
+
+        // Destroys the elements; committed pages stay for reuse.
+        void clear() noexcept {
+            for (usize i = _len; i > 0; --i) _ptr[i - 1].~T();
+            _len = 0;
+        }
+
+    private:
+        T* _ptr{ nullptr };     // base of the reserved range
+        usize _len{ 0 };
+        usize _cap{ 0 };        // elements backed by committed pages
+        usize _max;             // elements the reservation can hold
+        usize _reserved{ 0 };   // reserved bytes
+
+        IO_NODISCARD bool reserve_range() noexcept {
+            if (_max == 0) return false;
+            const usize page = io::page_size();
+            const usize bytes = (_max * sizeof(T) + page - 1) & ~(page - 1);
+            void* p = io::reserve_pages(bytes);
+            if (!p) return false;
+            _ptr = static_cast<T*>(p);
+            _reserved = bytes;
+            return true;
+        }
+    }; // struct stable_vector
+} // namespace io
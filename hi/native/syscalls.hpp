@@ -4,12 +4,23 @@
 #ifdef _WIN32
 #   define WIN32_LEAN_AND_MEAN
 #   include <Windows.h>
+#   pragma comment(lib, "Synchronization.lib") // WaitOnAddress
 #elif defined (__linux__)
-    // linux includes here
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   include <linux/futex.h>
+#   include <unistd.h>
+#   include <time.h>
+#   include <pthread.h>
 #else
 #   error "OS isn't specified"
 #endif // WIN32
 
+// Huge page size assumed on Linux (x86-64 / arm64 with 4 KiB base pages).
+#ifndef IO_HUGE_PAGE_BYTES
+#   define IO_HUGE_PAGE_BYTES (2u * 1024u * 1024u)
+#endif
+
 
 namespace io {
     namespace global {
@@ -51,6 +62,268 @@ namespace io {
     }
 
 
+    // --- Pages ---
+    // Raw page mappings: page-aligned, no hidden header, caller keeps the size.
+
+    static inline usize page_size() noexcept {
+#ifdef _WIN32
+        SYSTEM_INFO si;
+        ::GetSystemInfo(&si);
+        return static_cast<usize>(si.dwPageSize);
+#elif defined(__linux__)
+        return static_cast<usize>(::sysconf(_SC_PAGESIZE));
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    static inline void* map_pages(usize bytes) noexcept {
+#ifdef _WIN32
+        return ::VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#elif defined(__linux__)
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    static inline void unmap_pages(void* ptr, usize bytes) noexcept {
+        if (!ptr) return;
+#ifdef _WIN32
+        (void)bytes;
+        ::VirtualFree(ptr, 0, MEM_RELEASE);
+#elif defined(__linux__)
+        ::munmap(ptr, bytes);
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    // Address space only: no memory behind it until `commit_pages`.
+    // Release the whole range with `unmap_pages(ptr, bytes)`.
+    static inline void* reserve_pages(usize bytes) noexcept {
+#ifdef _WIN32
+        return ::VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS);
+#elif defined(__linux__)
+        void* p = ::mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    // Make [ptr, ptr + bytes) of a reserved range readable and writable;
+    // both are page multiples. Pages still fault in on first touch.
+    IO_NODISCARD static inline bool commit_pages(void* ptr, usize bytes) noexcept {
+#ifdef _WIN32
+        return ::VirtualAlloc(ptr, bytes, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#elif defined(__linux__)
+        return ::mprotect(ptr, bytes, PROT_READ | PROT_WRITE) == 0;
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    // Hands the physical pages of [ptr, ptr + bytes) back to the OS but keeps
+    // the range mapped and readable; the contents become unspecified (zero on
+    // Linux) and pages are faulted back in on the next touch.
+    static inline void discard_pages(void* ptr, usize bytes) noexcept {
+        if (!ptr) return;
+#ifdef _WIN32
+        ::VirtualAlloc(ptr, bytes, MEM_RESET, PAGE_READWRITE);
+        ::VirtualUnlock(ptr, bytes); // on unlocked pages: drops them from the working set
+#elif defined(__linux__)
+        ::madvise(ptr, bytes, MADV_DONTNEED);
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    // `align` is a power of two; release with `unmap_pages(ptr, bytes)`.
+    static inline void* map_pages_aligned(usize bytes, usize align) noexcept {
+        if (bytes > ~usize(0) - align) return nullptr; // the over-sized range can't exist
+#ifdef _WIN32
+        // VirtualAlloc already returns 64 KiB (allocation granularity) aligned bases
+        void* p = ::VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        if (!p || (reinterpret_cast<usize>(p) & (align - 1)) == 0) return p;
+        ::VirtualFree(p, 0, MEM_RELEASE);
+
+        // reserve an oversized range to find an aligned address, then claim it
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            void* probe = ::VirtualAlloc(nullptr, bytes + align, MEM_RESERVE, PAGE_NOACCESS);
+            if (!probe) return nullptr;
+            const usize at = (reinterpret_cast<usize>(probe) + align - 1) & ~(align - 1);
+            ::VirtualFree(probe, 0, MEM_RELEASE);
+            p = ::VirtualAlloc(reinterpret_cast<void*>(at), bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+            if (p) return p; // lost a race for the range otherwise
+        }
+        return nullptr;
+#elif defined(__linux__)
+        // over-map, then give the unaligned head and the tail back
+        u8* raw = static_cast<u8*>(map_pages(bytes + align));
+        if (!raw) return nullptr;
+        const usize at = (reinterpret_cast<usize>(raw) + align - 1) & ~(align - 1);
+        u8* p = reinterpret_cast<u8*>(at);
+        const usize head = static_cast<usize>(p - raw);
+        if (head) ::munmap(raw, head);
+        if (align - head) ::munmap(p + bytes, align - head);
+        return p;
+#else
+#   error "Not implemented"
+#endif
+    }
+
+
+    // --- Aligned allocate ---
+    // `align` is a power of two: 32/64 for SIMD data or cache-line padding,
+    // page_size() and up for DMA-style I/O buffers. The base and length are
+    // kept just below the returned pointer (one `align` step, at least 16
+    // bytes, is spent on them); release with `io::free_aligned`.
+    static inline void* alloc_aligned(usize bytes, usize align) noexcept {
+        if (align < 2 * sizeof(usize)) align = 2 * sizeof(usize);
+        const usize page = page_size();
+        const usize total = (align + bytes + page - 1) & ~(page - 1);
+        u8* base = static_cast<u8*>(align <= page ? map_pages(total) : map_pages_aligned(total, align));
+        if (!base) return nullptr;
+        usize* p = reinterpret_cast<usize*>(base + align);
+        p[-2] = reinterpret_cast<usize>(base);
+        p[-1] = total;
+        return p;
+    }
+
+    static inline void free_aligned(void* ptr) noexcept {
+        if (!ptr) return;
+        const usize* p = static_cast<const usize*>(ptr);
+        unmap_pages(reinterpret_cast<void*>(p[-2]), p[-1]);
+    }
+
+    // Resizes a `map_pages_aligned(old_bytes, align)` mapping, letting the
+    // kernel move page tables instead of copying the contents; the result is
+    // still `align`-aligned. Returns nullptr where unsupported or on failure,
+    // with the old mapping untouched.
+    static inline void* remap_pages(void* ptr, usize old_bytes, usize new_bytes, usize align) noexcept {
+#ifdef _WIN32
+        (void)ptr; (void)old_bytes; (void)new_bytes; (void)align;
+        return nullptr; // no mremap; callers copy
+#elif defined(__linux__)
+        // shrink, or grow into a free tail, without moving
+        void* p = ::mremap(ptr, old_bytes, new_bytes, 0);
+        if (p != MAP_FAILED) return p;
+
+        // move into an aligned hole: reserve, remap over it, trim the rest
+        u8* raw = static_cast<u8*>(reserve_pages(new_bytes + align));
+        if (!raw) return nullptr;
+        u8* at = reinterpret_cast<u8*>((reinterpret_cast<usize>(raw) + align - 1) & ~(align - 1));
+        p = ::mremap(ptr, old_bytes, new_bytes, MREMAP_MAYMOVE | MREMAP_FIXED, at);
+        if (p == MAP_FAILED) {
+            ::munmap(raw, new_bytes + align);
+            return nullptr;
+        }
+        const usize head = static_cast<usize>(at - raw);
+        if (head) ::munmap(raw, head);
+        if (align - head) ::munmap(at + new_bytes, align - head);
+        return p;
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    // --- Page options ---
+    // Opt-in behavior for `map_pages` / `alloc`. Every flag degrades quietly:
+    // when the OS can't honor it, plain lazily-faulted pages are returned.
+    enum class PageFlags : u8 {
+        None      = 0,
+        HugePages = 1u << 0, // explicit huge pages (MAP_HUGETLB / MEM_LARGE_PAGES), else HugeHint
+        HugeHint  = 1u << 1, // transparent huge pages (MADV_HUGEPAGE); no-op on Windows
+        Prefault  = 1u << 2, // fault every page in up front instead of on first touch
+    };
+
+    IO_NODISCARD IO_CONSTEXPR PageFlags operator|(PageFlags a, PageFlags b) noexcept {
+        return static_cast<PageFlags>(static_cast<u8>(a) | static_cast<u8>(b));
+    }
+    IO_NODISCARD IO_CONSTEXPR PageFlags operator&(PageFlags a, PageFlags b) noexcept {
+        return static_cast<PageFlags>(static_cast<u8>(a) & static_cast<u8>(b));
+    }
+    IO_NODISCARD IO_CONSTEXPR bool has(PageFlags m, PageFlags f) noexcept {
+        return (static_cast<u8>(m) & static_cast<u8>(f)) != 0;
+    }
+
+    // 0 when the system has no huge pages to offer.
+    static inline usize huge_page_size() noexcept {
+#ifdef _WIN32
+        return static_cast<usize>(::GetLargePageMinimum());
+#elif defined(__linux__)
+        return IO_HUGE_PAGE_BYTES;
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    // Touches one byte per page so later accesses don't fault.
+    static inline void prefault_pages(void* ptr, usize bytes) noexcept {
+        if (!ptr) return;
+        volatile u8* p = static_cast<volatile u8*>(ptr);
+        const usize page = page_size();
+        for (usize i = 0; i < bytes; i += page) p[i] = p[i];
+    }
+
+    // Explicit huge pages are used only when `bytes` is a multiple of
+    // huge_page_size(). Release with `unmap_pages(ptr, bytes)`.
+    static inline void* map_pages(usize bytes, PageFlags flags) noexcept {
+        const usize huge = huge_page_size();
+        const bool  fits_huge = huge && bytes % huge == 0;
+#ifdef _WIN32
+        if (has(flags, PageFlags::HugePages) && fits_huge) {
+            // needs SeLockMemoryPrivilege; large pages are never paged out,
+            // so there is nothing left to prefault
+            void* p = ::VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (p) return p;
+        }
+        void* p = map_pages(bytes);
+        if (p && has(flags, PageFlags::Prefault)) prefault_pages(p, bytes);
+        return p;
+#elif defined(__linux__)
+        const int populate = has(flags, PageFlags::Prefault) ? MAP_POPULATE : 0;
+        if (has(flags, PageFlags::HugePages) && fits_huge) {
+            void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+            if (p != MAP_FAILED) return p; // otherwise no huge pages reserved
+        }
+        if (!has(flags, PageFlags::HugePages | PageFlags::HugeHint)) {
+            void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | populate, -1, 0);
+            return p == MAP_FAILED ? nullptr : p;
+        }
+        // the hint must land before the first fault, so populate afterwards
+        void* p = map_pages(bytes);
+        if (!p) return nullptr;
+        ::madvise(p, bytes, MADV_HUGEPAGE);
+        if (populate) prefault_pages(p, bytes);
+        return p;
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    // `alloc` with page options; release with `io::free`.
+    // HugePages rounds the mapping up to whole huge pages.
+    static inline void* alloc(usize bytes, PageFlags flags) noexcept {
+        const usize huge = has(flags, PageFlags::HugePages) ? huge_page_size() : 0;
+#ifdef _WIN32
+        if (huge) bytes = (bytes + huge - 1) & ~(huge - 1);
+        return map_pages(bytes, flags);
+#elif defined(__linux__)
+        usize total = bytes + sizeof(usize);
+        if (huge) total = (total + huge - 1) & ~(huge - 1);
+        u8* base = static_cast<u8*>(map_pages(total, flags));
+        if (!base) return nullptr;
+        *reinterpret_cast<usize*>(base) = total - sizeof(usize); // what `free` unmaps
+        return base + sizeof(usize);
+#else
+#   error "Not implemented"
+#endif
+    }
+
     // --- Exit Process ---
     static inline void exit_process(int error_code) noexcept {
 #ifdef _WIN32
@@ -73,6 +346,89 @@ namespace io {
 #endif
     }
 
+    // --- Address Wait (futex) ---
+    // Blocks while `*addr == expected`; returns at once if it already differs.
+    // Wake-ups may be spurious, so callers re-check their condition in a loop.
+    // Process-private: `addr` must not live in shared memory.
+    static inline void futex_wait(const u32* addr, u32 expected) noexcept {
+#ifdef _WIN32
+        ::WaitOnAddress(const_cast<u32*>(addr), &expected, sizeof(u32), INFINITE);
+#elif defined(__linux__)
+        ::syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    // Wakes one / every thread blocked in `futex_wait` on `addr`.
+    static inline void futex_wake_one(const u32* addr) noexcept {
+#ifdef _WIN32
+        ::WakeByAddressSingle(const_cast<u32*>(addr));
+#elif defined(__linux__)
+        ::syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    static inline void futex_wake_all(const u32* addr) noexcept {
+#ifdef _WIN32
+        ::WakeByAddressAll(const_cast<u32*>(addr));
+#elif defined(__linux__)
+        ::syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 0x7fffffff, nullptr, nullptr, 0);
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    // --- Thread Keys ---
+    // Per-thread pointer slots that need no C runtime TLS support (fiber local
+    // storage on Windows, pthread keys on Linux). The destructor runs when a
+    // thread exits, once for every non-null value it left in the key.
+#ifdef _WIN32
+#   define IO_THREAD_KEY_CALLBACK NTAPI
+    using thread_key = DWORD;
+#elif defined(__linux__)
+#   define IO_THREAD_KEY_CALLBACK
+    using thread_key = pthread_key_t;
+#else
+#   error "Not implemented"
+#endif
+    using thread_key_destructor = void (IO_THREAD_KEY_CALLBACK*)(void*);
+
+    static inline bool thread_key_create(thread_key& key, thread_key_destructor dtor) noexcept {
+#ifdef _WIN32
+        const DWORD k = ::FlsAlloc(dtor);
+        if (k == FLS_OUT_OF_INDEXES) return false;
+        key = k;
+        return true;
+#elif defined(__linux__)
+        return ::pthread_key_create(&key, dtor) == 0;
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    static inline void* thread_key_get(thread_key key) noexcept {
+#ifdef _WIN32
+        return ::FlsGetValue(key);
+#elif defined(__linux__)
+        return ::pthread_getspecific(key);
+#else
+#   error "Not implemented"
+#endif
+    }
+
+    static inline bool thread_key_set(thread_key key, void* value) noexcept {
+#ifdef _WIN32
+        return ::FlsSetValue(key, value) != FALSE;
+#elif defined(__linux__)
+        return ::pthread_setspecific(key, value) == 0;
+#else
+#   error "Not implemented"
+#endif
+    }
+
     // --- Monotonic Timer ---
     static inline double monotonic_seconds() noexcept {
 #ifdef _WIN32
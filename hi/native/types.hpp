@@ -1,5 +1,15 @@
 ﻿#pragma once
 
+#if defined(_MSC_VER) && !defined(__clang__)
+// Declared here instead of pulling in <cstring>; IO_MEMCPY & co. below.
+extern "C" {
+    void* __cdecl memcpy(void* dest, const void* src, decltype(sizeof(0)) count);
+    void* __cdecl memmove(void* dest, const void* src, decltype(sizeof(0)) count);
+    void* __cdecl memset(void* dest, int ch, decltype(sizeof(0)) count);
+}
+#pragma intrinsic(memcpy, memset)
+#endif
+
 namespace io {
 
 // --- Includeless fixed-width integer types ---
@@ -112,6 +122,28 @@ namespace global {                                                \
 #  endif
 #endif
 
+// ------------------ IO_MEMCPY / IO_MEMMOVE / IO_MEMSET ----------------------
+// Compiler builtins: small constant sizes inline, everything else becomes a
+// call to memcpy/memmove/memset (supplied by hi/source.cpp in CRT-free builds).
+#if defined(_MSC_VER) && !defined(__clang__)
+#   define IO_MEMCPY(dst, src, n)  ::memcpy((dst), (src), (n))
+#   define IO_MEMMOVE(dst, src, n) ::memmove((dst), (src), (n))
+#   define IO_MEMSET(dst, ch, n)   ::memset((dst), (ch), (n))
+#else
+#   define IO_MEMCPY(dst, src, n)  __builtin_memcpy((dst), (src), (n))
+#   define IO_MEMMOVE(dst, src, n) __builtin_memmove((dst), (src), (n))
+#   define IO_MEMSET(dst, ch, n)   __builtin_memset((dst), (ch), (n))
+#endif
+
+// ------------------------ IO_IS_CONSTANT_EVALUATED -------------------------
+// Lets constexpr functions keep a plain loop for compile time and call
+// non-constexpr (SIMD) kernels at run time.
+#if (defined(__GNUC__) && __GNUC__ >= 9) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#   define IO_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#   define IO_IS_CONSTANT_EVALUATED() false
+#endif
+
 #pragma endregion // macros
 
 IO_CONSTEXPR usize len(const char* s) noexcept {
@@ -157,6 +189,84 @@ IO_CONSTEXPR_VAR bool is_same_v = is_same<A, B>::value;
 template<typename...>
 using void_t = void;
 
+// ---------------- is_trivially_relocatable -------------------
+// Moving a T to a new address and forgetting the old one is a plain byte
+// copy: containers may memcpy / remap such buffers instead of running a move
+// constructor and destructor per element. Defaults to the compiler's
+// trivially-copyable check; specialize to opt other types in.
+
+template<typename T>
+struct is_trivially_relocatable : constant<bool, __is_trivially_copyable(T)> {};
+
+template<typename T>
+IO_CONSTEXPR_VAR bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// ------------- is_trivially_copyable / destructible ----------
+// Compiler intrinsics (no <type_traits>). Trivially default constructible
+// types that are also trivially copyable value-initialize to all zero bytes.
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 14
+#   define IO_IS_TRIVIALLY_DESTRUCTIBLE(T) __has_trivial_destructor(T)
+#else
+#   define IO_IS_TRIVIALLY_DESTRUCTIBLE(T) __is_trivially_destructible(T)
+#endif
+
+template<typename T>
+struct is_trivially_copyable : constant<bool, __is_trivially_copyable(T)> {};
+
+template<typename T>
+struct is_trivially_destructible : constant<bool, IO_IS_TRIVIALLY_DESTRUCTIBLE(T)> {};
+
+template<typename T>
+struct is_trivially_default_constructible : constant<bool, __is_trivially_constructible(T)> {};
+
+template<typename T>
+IO_CONSTEXPR_VAR bool is_trivially_copyable_v = is_trivially_copyable<T>::value;
+template<typename T>
+IO_CONSTEXPR_VAR bool is_trivially_destructible_v = is_trivially_destructible<T>::value;
+template<typename T>
+IO_CONSTEXPR_VAR bool is_trivially_default_constructible_v = is_trivially_default_constructible<T>::value;
+
+// -------------------------- is_byte --------------------------
+// Byte-sized character/integer types: views over them search with the
+// vectorized kernels in search.hpp.
+
+template<typename T> struct is_byte : false_t {};
+template<typename T> struct is_byte<const T> : is_byte<T> {};
+template<> struct is_byte<char> : true_t {};
+template<> struct is_byte<signed char> : true_t {};
+template<> struct is_byte<unsigned char> : true_t {};
+#if defined(__cpp_char8_t)
+template<> struct is_byte<char8_t> : true_t {};
+#endif
+
+// ------------------------ is_integral ------------------------
+// Built-in integer types (hash_map hashes them by value).
+
+template<typename T> struct is_integral : false_t {};
+template<typename T> struct is_integral<const T> : is_integral<T> {};
+template<> struct is_integral<bool> : true_t {};
+template<> struct is_integral<char> : true_t {};
+template<> struct is_integral<signed char> : true_t {};
+template<> struct is_integral<unsigned char> : true_t {};
+template<> struct is_integral<wchar_t> : true_t {};
+template<> struct is_integral<char16_t> : true_t {};
+template<> struct is_integral<char32_t> : true_t {};
+#if defined(__cpp_char8_t)
+template<> struct is_integral<char8_t> : true_t {};
+#endif
+template<> struct is_integral<short> : true_t {};
+template<> struct is_integral<unsigned short> : true_t {};
+template<> struct is_integral<int> : true_t {};
+template<> struct is_integral<unsigned int> : true_t {};
+template<> struct is_integral<long> : true_t {};
+template<> struct is_integral<unsigned long> : true_t {};
+template<> struct is_integral<long long> : true_t {};
+template<> struct is_integral<unsigned long long> : true_t {};
+
+template<typename T>
+IO_CONSTEXPR_VAR bool is_integral_v = is_integral<T>::value;
+
 // -------- Convenience macro for enabling functions -----------
 
 #define IO_REQUIRES(...) typename = enable_if_t<(__VA_ARGS__)>
@@ -179,6 +289,16 @@ IO_CONSTEXPR T&& forward(remove_reference_t<T>& t) noexcept { return static_cast
 template<typename T>
 IO_CONSTEXPR T&& forward(remove_reference_t<T>&& t) noexcept { return static_cast<T&&>(t); }
 
+// Unevaluated contexts only (decltype / sizeof).
+template<typename T>
+T&& declval() noexcept;
+
+
+namespace native { // search.hpp
+    IO_NODISCARD inline usize find_byte(const u8* p, usize n, u8 b) noexcept;
+    IO_NODISCARD inline usize find_any_byte(const u8* p, usize n, const u8* set, usize set_n) noexcept;
+    IO_NODISCARD inline usize find_bytes(const u8* hay, usize n, const u8* needle, usize m) noexcept;
+}
 
 // ============================================================
 //                   universal view (like span)
@@ -239,9 +359,13 @@ struct view {
 
     static constexpr usize npos = static_cast<usize>(-1);
 
+    // Byte views (char, u8, ...) use the SIMD kernels at run time.
+
     // 1) find single value
     IO_CONSTEXPR usize find(const T& value, usize pos = 0) const noexcept {
         if (pos >= _len) return npos;
+        if (is_byte<T>::value && !IO_IS_CONSTANT_EVALUATED())
+            return find_bytes(&value, 1, pos, is_byte<T>{});
         for (usize i = pos; i < _len; ++i) {
             if (_ptr[i] == value)
                 return i;
@@ -257,6 +381,8 @@ struct view {
         if (needle._len > _len || pos > _len - needle._len)
             return npos;
 
+        if (is_byte<T>::value && !IO_IS_CONSTANT_EVALUATED())
+            return find_bytes(needle._ptr, needle._len, pos, is_byte<T>{});
         for (usize i = pos; i <= _len - needle._len; ++i) {
             usize j = 0;
             for (; j < needle._len; ++j) {
@@ -276,6 +402,18 @@ struct view {
         return find(view(needle, needle_len), pos);
     }
 
+    // 4) first element equal to any of `set` (multi-delimiter scan)
+    IO_CONSTEXPR usize find_first_of(view set, usize pos = 0) const noexcept {
+        if (pos >= _len) return npos;
+        if (is_byte<T>::value && !IO_IS_CONSTANT_EVALUATED())
+            return find_any(set, pos, is_byte<T>{});
+        for (usize i = pos; i < _len; ++i) {
+            for (usize k = 0; k < set._len; ++k)
+                if (_ptr[i] == set._ptr[k]) return i;
+        }
+        return npos;
+    }
+
     // -------------------- Comparisons ---------------------------
 
     // view == view
@@ -310,6 +448,21 @@ struct view {
 protected:
     T* _ptr;
     usize _len;
+
+private:
+    static const u8* as_bytes(const T* p) noexcept { return reinterpret_cast<const u8*>(p); }
+
+    usize find_bytes(const T* needle, usize m, usize pos, true_t) const noexcept {
+        const usize r = native::find_bytes(as_bytes(_ptr) + pos, _len - pos, as_bytes(needle), m);
+        return r == npos ? npos : pos + r;
+    }
+    usize find_any(view set, usize pos, true_t) const noexcept {
+        const usize r = native::find_any_byte(as_bytes(_ptr) + pos, _len - pos, as_bytes(set._ptr), set._len);
+        return r == npos ? npos : pos + r;
+    }
+    // never called: only byte views take the kernel paths
+    usize find_bytes(const T*, usize, usize, false_t) const noexcept { return npos; }
+    usize find_any(view, usize, false_t) const noexcept { return npos; }
 }; // struct view<T>
 
 // ---------------- convenience aliases -----------------------
@@ -673,4 +826,7 @@ namespace hi {
         }
     } // what
 #pragma endregion
-} // namespace hi
\ No newline at end of file
+} // namespace hi
+
+// Definitions of the view<byte> search kernels declared above.
+#include "search.hpp"
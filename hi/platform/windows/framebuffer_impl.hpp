@@ -124,6 +124,10 @@ namespace hi {
 
             _pixels = ppv_bits;
 
+            // Take the first-touch page faults now instead of in the first frame
+            if (io::has(_page_flags, io::PageFlags::Prefault))
+                io::prefault_pages(_pixels, static_cast<io::usize>(width_) * height_ * 4);
+
             return true;
         } // Framebuffer::Recreate
 
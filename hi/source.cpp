@@ -1,12 +1,16 @@
 #include "io.hpp"
 #include "native/syscalls.hpp"
 #include "native/slot_alloc.hpp"
+#include "native/mem.hpp"
 #include "native/window.hpp"
 
 #pragma region micro shit
 // ============================================================================
 // I *** hate Microsoft products
 #if defined(IO_NOSTD) && defined(IO_MICROSHIT_NOSTD)
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma function(memcpy, memset) // defined below; types.hpp marks them intrinsic
+#endif
 namespace std {
     extern const nothrow_t nothrow;
     using size_t = io::usize;
@@ -20,17 +24,20 @@ extern "C" {
     // static void __cdecl __security_check_cookie(uintptr_t) { (void)/*cookie*/0; }
 
     // issue: linker couldn't find memcpy function
+    // The compiler lowers struct copies and zeroing to these, so they run
+    // the word/SIMD kernels in io::mem rather than byte loops.
     void* __cdecl memcpy(void* dest, const void* src, std::size_t count) {
-        unsigned char* d = static_cast<unsigned char*>(dest);
-        const unsigned char* s = static_cast<const unsigned char*>(src);
-        while (count--) *d++ = *s++;
-        return dest;
+        return io::mem::copy(dest, src, count);
+    }
+    void* __cdecl memmove(void* dest, const void* src, std::size_t count) {
+        return io::mem::move(dest, src, count);
     }
     // issue: linker couldn't find memset function
     void* __cdecl memset(void* dest, int ch, std::size_t count) {
-        unsigned char* d = static_cast<unsigned char*>(dest);
-        while (count--) *d++ = static_cast<unsigned char>(ch);
-        return dest;
+        return io::mem::set(dest, ch, count);
+    }
+    int __cdecl memcmp(const void* lhs, const void* rhs, std::size_t count) {
+        return io::mem::compare(lhs, rhs, count);
     }
 
 } // extern "C"
@@ -46,18 +53,57 @@ namespace hi {
     } // namespace global
 } // namespace hi
 
+namespace io {
+    namespace native {
+        namespace global {
+            // Allocator state shared by every translation unit (constant-initialized,
+            // so it is usable from operator new during other static initializers).
+            ChunkMap chunk_map;
+
+            Pool8   pool8;
+            Pool16  pool16;
+            Pool32  pool32;
+            Pool64  pool64;
+            Pool128 pool128;
+            Pool256 pool256;
+            Pool512   pool512;
+            Pool1024  pool1024;
+            Pool2048  pool2048;
+            Pool4096  pool4096;
+            Pool8192  pool8192;
+            Pool16384 pool16384;
+            Pool32768 pool32768;
+            Pool65536 pool65536;
+
+            TrimState trim_state;
+
+#ifdef IO_ALLOC_STATS
+            AllocCounters alloc_counters;
+#endif
+
+#if !defined(IO_NO_THREAD_CACHE) && defined(IO_THREAD_CACHE_KEYED)
+            ThreadCacheKey thread_cache_key;
+#elif !defined(IO_NO_THREAD_CACHE)
+            thread_local Magazine magazines[POOL_COUNT]{};
+            thread_local bool thread_cache_armed{ false };
+            thread_local ThreadCacheExit thread_cache_exit;
+#endif
+        } // namespace global
+    } // namespace native
+} // namespace io
+
 
 #if defined(IO_NOSTD)
 // ============================================================================
 // -------- Single object --------
 void* __CRTDECL operator new(std::size_t size)                                 { return io::native::allocate_block(size); }
 void __CRTDECL operator delete(void* ptr) noexcept                             { io::native::deallocate_block(ptr); }
-void __CRTDECL operator delete(void* ptr, std::size_t) noexcept                { io::native::deallocate_block(ptr); }
+void __CRTDECL operator delete(void* ptr, std::size_t size) noexcept           { io::native::deallocate_block(ptr, size); }
 
 // ------------ Array ------------
 void* __CRTDECL operator new[](std::size_t size)                               { return io::native::allocate_block(size); }
 void __CRTDECL operator delete[](void* ptr) noexcept                           { io::native::deallocate_block(ptr); }
-void __CRTDECL operator delete[](void* ptr, std::size_t) noexcept              { io::native::deallocate_block(ptr); }
+void __CRTDECL operator delete[](void* ptr, std::size_t size) noexcept         { io::native::deallocate_block(ptr, size); }
 
 // ---- Nothrow single object ----
 void* __CRTDECL operator new(std::size_t size, const std::nothrow_t&) noexcept { return io::native::allocate_block(size); }
@@ -66,4 +112,20 @@ void __CRTDECL operator delete(void* ptr, const std::nothrow_t&) noexcept      {
 // -------- Nothrow array --------
 void* __CRTDECL operator new[](std::size_t size, const std::nothrow_t&) noexcept { return io::native::allocate_block(size); }
 void __CRTDECL operator delete[](void* ptr, const std::nothrow_t&) noexcept    { io::native::deallocate_block(ptr); }
+
+#ifdef __cpp_aligned_new
+// ---------- Over-aligned ----------
+// The chunk map knows every block's size, so unsized deletes need no alignment.
+void* __CRTDECL operator new(std::size_t size, std::align_val_t al)                                  { return io::native::allocate_block_aligned(size, static_cast<io::usize>(al)); }
+void* __CRTDECL operator new[](std::size_t size, std::align_val_t al)                                { return io::native::allocate_block_aligned(size, static_cast<io::usize>(al)); }
+void* __CRTDECL operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept   { return io::native::allocate_block_aligned(size, static_cast<io::usize>(al)); }
+void* __CRTDECL operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return io::native::allocate_block_aligned(size, static_cast<io::usize>(al)); }
+
+void __CRTDECL operator delete(void* ptr, std::align_val_t) noexcept                                 { io::native::deallocate_block(ptr); }
+void __CRTDECL operator delete[](void* ptr, std::align_val_t) noexcept                               { io::native::deallocate_block(ptr); }
+void __CRTDECL operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept          { io::native::deallocate_block(ptr); }
+void __CRTDECL operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept        { io::native::deallocate_block(ptr); }
+void __CRTDECL operator delete(void* ptr, std::size_t size, std::align_val_t al) noexcept            { io::native::deallocate_block_aligned(ptr, size, static_cast<io::usize>(al)); }
+void __CRTDECL operator delete[](void* ptr, std::size_t size, std::align_val_t al) noexcept          { io::native::deallocate_block_aligned(ptr, size, static_cast<io::usize>(al)); }
+#endif // __cpp_aligned_new
 #endif // IO_NOSTD
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "native/window.hpp"
 #include "native/framebuffer.hpp"
 #include "native/opengl.hpp"
+#include "native/arena.hpp"
 
 namespace hi {
     // --- CRTP base ---
@@ -49,6 +50,9 @@ namespace hi {
         IO_NODISCARD inline const native::Window& native() const noexcept override { return _native_window; }
         IO_NODISCARD inline int width() const noexcept override { return _width; }
         IO_NODISCARD inline int height() const noexcept override { return _height; }
+        // Scratch memory for the frame being rendered; reset by every Render(),
+        // allocations from the previous frame stay valid for one more frame.
+        IO_NODISCARD inline io::Arena& frameArena() noexcept { return _frame_arena.current(); }
         inline void onGeometryChange(int w, int h) noexcept override;
 
     public:
@@ -77,6 +81,7 @@ namespace hi {
     private:
         native::Window _native_window;
         RendererApi _renderer_api{ RendererApi::None };
+        io::FrameArena<2> _frame_arena;
         
         int _width;
         int _height;
@@ -130,6 +135,7 @@ namespace hi {
 
     template <typename Derived>
     inline void Window<Derived>::Render() noexcept {
+        _frame_arena.next();
         switch (api()) {
         case RendererApi::Software: fb.Render(*this); break;
         case RendererApi::Opengl: g.Render(*this); break;